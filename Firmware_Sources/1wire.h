@@ -26,23 +26,45 @@
 // 0x01 ... 0x40: continue searching
 #define DEVICE_REMOVED 0xAA55
 
+// Pseudo commands of a request
+#define W1_RESET_ONLY  0x00          // Reset and presence detection only
+#define W1_NO_RESET    0x01          // No reset and ROM command, just read, e.g. to poll a running conversion
+
+// Max. number of queued requests
+#define W1_QUEUE_LENGTH 4
+
+// Timer 1 counts (prescaler 8) for a time in microseconds
+#define W1_TICKS( US )  ( (uint16_t)( ( F_CPU / 8 ) * ( US ) / 1000000UL ) )
+
+// w1_wait() gives up after this time (the longest transaction takes about 15ms, even with a full queue ahead)
+#define W1_TIMEOUT_US   CLOCK_MS( 100 )
+
 #ifndef NULL
     #define NULL       ( (void *)0 ) // Nullpointer
 #endif
 
-uint8_t w1_reset( void );
+// Transaction on the bus, served by the Timer 1 compare B interrupt
+typedef struct {
+    uint8_t          command;  // Function command, SEARCH_ROM, W1_RESET_ONLY or W1_NO_RESET
+    uint8_t         *id;       // ROM-ID for MATCH_ROM (NULL: SKIP_ROM), ROM search: previous and found ID
+    uint8_t         *data;     // Bytes to write after the command, then bytes read
+    uint8_t          write;    // Number of bytes to write
+    uint8_t          read;     // Number of bytes to read
+    uint8_t          event;    // Posted when finished (EVENT_NONE: poll done or use w1_wait())
+    uint8_t          diff;     // ROM search: last discrepancy (SEARCH_FIRST), afterwards the next one
+    volatile uint8_t busy;
+    volatile uint8_t done;
+    volatile uint8_t result;   // 0, PRESENCE_ERR or DATA_ERR
+} w1_request_t;
 
-uint8_t w1_bit_io( uint8_t val );
-uint8_t w1_byte_wr( uint8_t byte );
-uint8_t w1_byte_rd( void );
-void w1_command( uint8_t command, uint8_t *id );
+uint8_t w1_request( w1_request_t *req );
+uint8_t w1_wait( w1_request_t *req );
+uint8_t w1_idle( void );
+uint8_t w1_transfer( uint8_t command, uint8_t *id, uint8_t *data, uint8_t write, uint8_t read );
 uint8_t w1_rom_search( uint8_t diff, uint8_t *id );
-uint8_t w1_get_sensor_ids( uint8_t id_field[][8] );
+uint8_t w1_get_sensor_ids( uint8_t id_field[][8], uint8_t max );
 
 // Speziell f�r 1-Wire-Temperatursensoren
-void w1_temp_conf( int8_t th, int8_t tl, uint8_t res );
-uint16_t w1_read_temp( uint8_t *id );
 int16_t w1_tempread_to_celsius( uint16_t temp, uint8_t digit );
-int16_t w1_tempmeas( uint8_t byten );
-void w1_temp_to_array( int32_t tempmalzehn, char *tempfield, uint8_t signdigit );
-#endif
\ No newline at end of file
+void    w1_temp_to_array( int32_t tempmalzehn, char *tempfield, uint8_t signdigit );
+#endif
@@ -6,7 +6,35 @@
 #ifndef ADC_H_
 #define ADC_H_
 
-void adc_init( void );
-void adc_deinit( void );
-uint8_t adc_read( uint8_t channel );
+// Sleep in ADC noise reduction mode while waiting for a result. Timer 1 (1-Wire slots, clock, ticks) and the UART
+// are halted meanwhile (up to about 1.5ms per reading), so it is skipped while a 1-Wire transfer, an ignition pulse
+// or UART output is running; bytes arriving from the PC can still get lost, hence off by default.
+// Conversions requested without waiting (impedance scan) never sleep
+#ifndef ADC_NOISE_SLEEP
+    #define ADC_NOISE_SLEEP 0
+#endif
+
+// Oversampling for battery and impedance readings (16 samples, 12 bit)
+#define ADC_EXTRA_BITS   2
+
+// Max. number of queued conversion requests
+#define ADC_QUEUE_LENGTH 4
+
+// Conversion request: result is the mean of 4^extra_bits (max. 3) samples with 10 + extra_bits bits,
+// event gets posted when it is ready (EVENT_NONE: poll done or use adc_wait())
+typedef struct {
+    uint8_t           channel;
+    uint8_t           extra_bits;
+    uint8_t           event;
+    volatile uint8_t  busy;
+    volatile uint8_t  done;
+    volatile uint16_t result;
+} adc_request_t;
+
+void     adc_init( void );
+void     adc_deinit( void );
+uint8_t  adc_request( adc_request_t *req );
+void     adc_wait( adc_request_t *req );
+uint16_t adc_sample( const uint8_t channel, const uint8_t extra_bits );
+uint8_t  adc_read( uint8_t channel );
 #endif
\ No newline at end of file
@@ -63,48 +63,37 @@ static void address_get( uint8_t *uid, uint8_t *sid, uint8_t storage_position )
     *sid = sid_local;
 }
 
-// Load addresses and make sure, they're stored correctly in all 3 places
-uint8_t addresses_load( uint8_t *uniqueid, uint8_t *slaveid ) {
+// Load addresses stored at the former fixed places (3 copies), only used to import them into the settings
+uint8_t addresses_legacy( uint8_t *uniqueid, uint8_t *slaveid ) {
     uint8_t sid_local = *slaveid, uid_local = *uniqueid;
 
     for ( uint8_t i = 0; i < 3; i++ ) {           // Try up to three times (three storage places)
         address_get( &uid_local, &sid_local, i ); // Read from memory
 
         if ( address_valid( uid_local, sid_local ) ) {                    // If valid numbers are found
-            if ( ID_MESS ) {
-                addresses_save( uid_local, sid_local );                   // Check if all storage positions are correct, rewrite if not
-
-            }
-
             *uniqueid = uid_local;
             *slaveid  = sid_local;
             return 1;
         }
-
-        if ( ( i == 2 ) && !( address_valid( uid_local, sid_local ) ) ) { // Return 0 if all tries failed
-            *uniqueid = 'E';
-            *slaveid  = 'e';
-            return 0;
-        }
     }
 
+    *uniqueid = 'E';                                                      // Return 0 if all tries failed
+    *slaveid  = 'e';
     return 0;
 }
 
-// Save IDs
+// Load addresses from the settings
+uint8_t addresses_load( uint8_t *uniqueid, uint8_t *slaveid ) {
+    *uniqueid = settings_get()->unique_id;
+    *slaveid  = settings_get()->slave_id;
+
+    return ( *uniqueid != 'E' ) || ( *slaveid != 'e' );
+}
+
+// Save IDs (written in the background, see settings_commit())
 void addresses_save( uint8_t uniqueid, uint8_t slaveid ) {
-    uint8_t sum     = uniqueid + slaveid;               // Summe der beiden IDs
-    uint8_t ucrc    = crc8( CRC_ID_STORAGE, uniqueid ); // CRC8-Wert of Unique-ID with seed 16
-    uint8_t scrc    = crc8( CRC_ID_STORAGE, slaveid );  // CRC8-Wert of Slave-ID with seed 16
-    uint8_t bothcrc = crc8( ucrc, slaveid );            // CRC8-Wert of Unique-ID and Slave-ID with seed 16
-
-    for ( uint8_t i = START_ADDRESS_ID_STORAGE; i < ( START_ADDRESS_ID_STORAGE + 3 * STEP_ID_STORAGE );
-          i += STEP_ID_STORAGE ) {
-        eewrite( uniqueid, i );
-        eewrite( slaveid, i + 1 );
-        eewrite( sum, i + 2 );
-        eewrite( ucrc, i + 3 );
-        eewrite( scrc, i + 4 );
-        eewrite( bothcrc, i + 5 );
-    }
-}
\ No newline at end of file
+    settings_get()->unique_id = uniqueid;
+    settings_get()->slave_id  = slaveid;
+
+    settings_save();
+}
@@ -10,6 +10,7 @@
 
 void update_addresses( uint8_t *unique_id, uint8_t *slave_id );
 uint8_t address_valid( uint8_t unique_id, uint8_t slave_id );
+uint8_t addresses_legacy( uint8_t *uniqueid, uint8_t *slaveid );
 uint8_t addresses_load( uint8_t *uniqueid, uint8_t *slaveid );
 void addresses_save( uint8_t uniqueid, uint8_t slaveid );
 #endif /* ADDRESSES_H_ */
\ No newline at end of file
@@ -0,0 +1,152 @@
+/*
+ * blackbox.c
+ *
+ * Event log in an EEPROM ring (see blackbox.h for the entry layout)
+ */
+
+#include "global.h"
+
+_Static_assert( sizeof( blackbox_entry_t ) == BLACKBOX_ENTRY_SIZE, "Wrong size of blackbox_entry_t!" );
+
+static blackbox_entry_t  blackbox_buffer[BLACKBOX_BUFFER];
+static uint8_t           blackbox_pending = 0;           // Entries in blackbox_buffer
+static uint8_t           blackbox_next    = 0, blackbox_seq = 0; // Slot and sequence number of the next entry
+
+// CRC8 of an entry (without the CRC byte)
+static uint8_t blackbox_crc( const blackbox_entry_t *entry ) {
+    uint8_t crc = BLACKBOX_CRC_SEED;
+
+    for ( uint8_t i = 0; i < BLACKBOX_ENTRY_SIZE - 1; i++ ) {
+        crc = crc8( crc, ( (const uint8_t *) entry )[i] );
+    }
+
+    return crc;
+}
+
+// Read entry from slot i, returns 1 if it is valid
+static uint8_t blackbox_slot( uint8_t i, blackbox_entry_t *entry ) {
+    for ( uint8_t j = 0; j < BLACKBOX_ENTRY_SIZE; j++ ) {
+        ( (uint8_t *) entry )[j] = eeread( BLACKBOX_START + i * BLACKBOX_ENTRY_SIZE + j );
+    }
+
+    return blackbox_valid( entry );
+}
+
+// Entry (read from EEPROM or received) is valid
+uint8_t blackbox_valid( const blackbox_entry_t *entry ) {
+    return entry->crc == blackbox_crc( entry );
+}
+
+// Find the newest entry, the next one goes to the slot after it
+void blackbox_init( void ) {
+    blackbox_entry_t entry, following;
+
+    for ( uint8_t i = 0; i < BLACKBOX_ENTRIES; i++ ) {
+        if ( !blackbox_slot( i, &entry ) ) {
+            continue;
+        }
+
+        if (  !blackbox_slot( ( i + 1 ) % BLACKBOX_ENTRIES, &following )
+           || ( following.seq != (uint8_t)( entry.seq + 1 ) ) ) {
+            blackbox_next = ( i + 1 ) % BLACKBOX_ENTRIES;
+            blackbox_seq  = entry.seq + 1;
+            break;
+        }
+    }
+}
+
+// Time in ms since start
+uint32_t blackbox_time( void ) {
+    return clock_ms();
+}
+
+// Add entry (only kept in RAM until blackbox_flush() writes it)
+void blackbox_add( uint8_t type, uint32_t time, uint8_t channel, uint8_t impedance ) {
+    blackbox_entry_t *entry;
+
+    if ( blackbox_pending >= BLACKBOX_BUFFER ) {
+        return;
+    }
+
+    entry            = &blackbox_buffer[blackbox_pending++];
+    entry->type      = type;
+    entry->time[0]   = time & 0xFF;
+    entry->time[1]   = ( time >> 8 ) & 0xFF;
+    entry->time[2]   = ( time >> 16 ) & 0xFF;
+    entry->channel   = channel;
+    entry->impedance = impedance;
+}
+
+// Entry waiting and room for it in the EEPROM queue
+uint8_t blackbox_ready( void ) {
+    return blackbox_pending && ( eeroom() >= BLACKBOX_ENTRY_SIZE );
+}
+
+// Write the oldest buffered entry if the EEPROM queue has room for it, never waits
+void blackbox_flush( void ) {
+    blackbox_entry_t *entry = &blackbox_buffer[0];
+
+    if ( !blackbox_ready() ) {
+        return;
+    }
+
+    entry->seq = blackbox_seq++;
+    entry->crc = blackbox_crc( entry );
+
+    for ( uint8_t i = 0; i < BLACKBOX_ENTRY_SIZE; i++ ) {
+        eewrite( ( (uint8_t *) entry )[i], BLACKBOX_START + blackbox_next * BLACKBOX_ENTRY_SIZE + i );
+    }
+
+    blackbox_next = ( blackbox_next + 1 ) % BLACKBOX_ENTRIES;
+
+    for ( uint8_t i = 1; i < blackbox_pending; i++ ) {
+        blackbox_buffer[i - 1] = blackbox_buffer[i];
+    }
+
+    blackbox_pending--;
+}
+
+// Read the n-th entry (0 = oldest one still stored), returns 0 if there is no valid entry
+uint8_t blackbox_read( uint8_t n, blackbox_entry_t *entry ) {
+    return blackbox_slot( ( blackbox_next + n ) % BLACKBOX_ENTRIES, entry );
+}
+
+// Build LOGDATA message with the entries from the n-th one on (invalid entries at the beginning are skipped).
+// Returns the number of the entry after the message (BLACKBOX_ENTRIES or more after the last one) or 0 if no valid
+// entry is left.
+uint8_t blackbox_to_frame( char *frame, uint8_t uid, uint8_t n ) {
+    blackbox_entry_t entry;
+
+    while ( ( n < BLACKBOX_ENTRIES ) && !blackbox_read( n, &entry ) ) {
+        n++;
+    }
+
+    if ( n >= BLACKBOX_ENTRIES ) {
+        return 0;
+    }
+
+    frame[0] = LOGDATA;
+    frame[1] = uid;
+    frame[2] = n;
+
+    for ( uint8_t i = 0; i < BLACKBOX_PER_MESSAGE; i++, n++ ) {
+        char *dest = &frame[BLACKBOX_MESSAGE + i * BLACKBOX_ENTRY_SIZE];
+
+        // Positions beyond the ring are sent as invalid entries
+        if ( n >= BLACKBOX_ENTRIES ) {
+            for ( uint8_t j = 0; j < BLACKBOX_ENTRY_SIZE; j++ ) {
+                dest[j] = 0;
+            }
+
+            continue;
+        }
+
+        blackbox_read( n, &entry );
+
+        for ( uint8_t j = 0; j < BLACKBOX_ENTRY_SIZE; j++ ) {
+            dest[j] = ( (uint8_t *) &entry )[j];
+        }
+    }
+
+    return n;
+}
@@ -7,34 +7,103 @@
 
 #include "global.h"
 
-// Read from EEPROM
+// Write queue, bytes are written one after another by the EE_READY interrupt
+typedef struct {
+    uint16_t address;
+    uint8_t  data;
+} ee_entry_t;
+
+static volatile ee_entry_t ee_queue[EE_QUEUE_SIZE];
+static volatile uint8_t    ee_head = 0, ee_tail = 0; // Written by eewrite() / by the interrupt
+
+// Start writing the next queued byte (interrupts disabled, previous write completed)
+static void ee_next( void ) {
+    if ( ee_head == ee_tail ) {
+        EECR &= ~( 1 << EERIE ); // Nothing left to do
+        return;
+    }
+
+    /* Set up address and Data Registers */
+    EEAR = ee_queue[ee_tail].address;
+    EEDR = ee_queue[ee_tail].data;
+    /* Write logical one to EEMPE, EEPE has to follow within 4 cycles */
+    EECR |= ( 1 << EEMPE );
+    /* Start eeprom write by setting EEPE */
+    EECR |= ( 1 << EEPE );
+
+    ee_tail = ( ee_tail + 1 ) & ( EE_QUEUE_SIZE - 1 );
+}
+
+// While interrupts are disabled (e.g. during boot) the queue is processed by polling
+static void ee_poll( void ) {
+    if ( !( SREG & ( 1 << SREG_I ) ) && !( EECR & ( 1 << EEPE ) ) ) {
+        ee_next();
+    }
+}
+
+// Read from EEPROM (bytes still waiting in the queue are not seen, use eeflush() before reading them back)
 uint8_t eeread( uint16_t address ) {
-    uint8_t data;
+    uint8_t data, eerie, temp_sreg = SREG;
+
+    /* No queued write may start until the byte is read: mask the EE_READY interrupt only, so the other
+       interrupts (1-Wire slots, UART, ADC) are served while a running write completes (up to 3.4ms) */
+    cli();
+    eerie = EECR & ( 1 << EERIE );
+    EECR &= ~( 1 << EERIE );
+    SREG  = temp_sreg;
+
+    /* Wait for completion of previous write, disable interrupts only for the read itself */
+    for ( ;; ) {
+        while ( EECR & ( 1 << EEPE ) );
+
+        cli();
 
-    /* Wait for completion of previous write */
-    while ( EECR & ( 1 << EEPE ) );
+        if ( !( EECR & ( 1 << EEPE ) ) ) {
+            break;
+        }
+
+        SREG = temp_sreg;
+    }
 
     /* Set up address register */
     EEAR = address;
     /* Start eeprom read by writing EERE */
     EECR |= ( 1 << EERE );
     /* Fetch data from Data Register */
-    data = EEDR;
-    EEAR = 0;
+    data  = EEDR;
+    EECR |= eerie;
+    SREG  = temp_sreg;
     return data;
 }
 
-// Write to EEPROM
+// Queue write to EEPROM, only waits if the queue is full
 void eewrite( uint8_t data, uint16_t address ) {
-    /* Wait for completion of previous write */
-    while ( EECR & ( 1 << EEPE ) );
+    uint8_t next = ( ee_head + 1 ) & ( EE_QUEUE_SIZE - 1 );
 
-    /* Set up address and Data Registers */
-    EEAR = address;
-    EEDR = data;
-    /* Write logical one to EEMPE */
-    EECR |= ( 1 << EEMPE );
-    /* Start eeprom write by setting EEPE */
-    EECR |= ( 1 << EEPE );
-    EEAR  = 0;
-}
\ No newline at end of file
+    while ( next == ee_tail ) {
+        ee_poll();
+    }
+
+    ee_queue[ee_head].address = address;
+    ee_queue[ee_head].data    = data;
+    ee_head                   = next;
+
+    EECR |= ( 1 << EERIE );
+    ee_poll();
+}
+
+// Free entries in the queue (eewrite() does not wait for up to this number of bytes)
+uint8_t eeroom( void ) {
+    return ( EE_QUEUE_SIZE - 1 ) - ( ( ee_head - ee_tail ) & ( EE_QUEUE_SIZE - 1 ) );
+}
+
+// Wait until all queued bytes have been written (has to be called before a reset)
+void eeflush( void ) {
+    while ( ( ee_head != ee_tail ) || ( EECR & ( 1 << EEPE ) ) ) {
+        ee_poll();
+    }
+}
+
+ISR( EE_READY_vect ) {
+    ee_next();
+}
@@ -0,0 +1,114 @@
+/*
+ * events.c
+ *
+ * Pending events of the main loop. The number of an event is its priority,
+ * 0 is the most urgent one. Events may be posted from interrupts as well,
+ * either at once or after a number of Timer 1 ticks.
+ */
+
+#include "global.h"
+
+// Ticks until a scheduled event gets posted, 0 = not scheduled
+static volatile uint16_t event_timers[EVENT_COUNT];
+
+// Register holding the pending flag of an event
+#define EVENT_REG( event ) ( *( ( event ) < 8 ? &GPIOR0 : ( ( event ) < 16 ? &GPIOR1 : &GPIOR2 ) ) )
+
+// Mark event as pending (event_post() ends up here unless it can set the flag with a single instruction)
+void event_post_any( uint8_t event ) {
+    uint8_t temp_sreg = SREG;
+    cli();
+    EVENT_REG( event ) |= ( 1 << ( event & 7 ) );
+    SREG                = temp_sreg;
+}
+
+// Drop event if it is pending
+void event_cancel( uint8_t event ) {
+    uint8_t temp_sreg = SREG;
+    cli();
+    EVENT_REG( event ) &= ~( 1 << ( event & 7 ) );
+    SREG                = temp_sreg;
+}
+
+// Check if event is pending
+uint8_t event_pending( uint8_t event ) {
+    return ( EVENT_REG( event ) & ( 1 << ( event & 7 ) ) ) && 1;
+}
+
+// Fetch the most urgent pending event and clear it. Flags only get set outside of the main loop,
+// so the snapshot stays valid without locking until the flag is cleared.
+uint8_t event_next( void ) {
+    uint8_t event = 0, pending = GPIOR0;
+
+    if ( !pending ) {
+        event   = 8;
+        pending = GPIOR1;
+
+        if ( !pending ) {
+            event   = 16;
+            pending = GPIOR2;
+
+            if ( !pending ) {
+                return EVENT_NONE;
+            }
+        }
+    }
+
+    while ( !( pending & 1 ) ) {
+        pending >>= 1;
+        event++;
+    }
+
+    event_cancel( event );
+
+    return event;
+}
+
+// Check if any event is pending
+uint8_t event_any( void ) {
+    return ( GPIOR0 | GPIOR1 | GPIOR2 ) && 1;
+}
+
+// Post event after the given number of ticks (replaces an earlier schedule, 0 posts at once)
+void event_post_in( uint8_t event, uint16_t ticks ) {
+    uint8_t temp_sreg;
+
+    if ( !ticks ) {
+        event_post_any( event );
+        return;
+    }
+
+    temp_sreg           = SREG;
+    cli();
+    event_timers[event] = ticks;
+    SREG                = temp_sreg;
+}
+
+// Drop schedule of an event
+void event_unschedule( uint8_t event ) {
+    uint8_t temp_sreg = SREG;
+    cli();
+    event_timers[event] = 0;
+    SREG                = temp_sreg;
+}
+
+// Ticks until the event gets posted, 0 if it is not scheduled
+uint16_t event_scheduled( uint8_t event ) {
+    uint16_t ticks;
+    uint8_t  temp_sreg = SREG;
+
+    cli();
+    ticks = event_timers[event];
+    SREG  = temp_sreg;
+
+    return ticks;
+}
+
+// Count down scheduled events (called by Timer 1 every 10ms)
+void event_tick( void ) {
+    for ( uint8_t i = 0; i < EVENT_COUNT; i++ ) {
+        if ( event_timers[i] && !--event_timers[i] ) {
+            event_post_any( i );
+        }
+    }
+}
@@ -0,0 +1,42 @@
+/*
+ * events.h
+ * Ereignisse der Hauptschleife, nach Priorität geordnet (Nummern siehe pyro.h), auch zeitgesteuert über Timer 1
+ */
+
+#ifndef EVENTS_H_
+#define EVENTS_H_
+
+// Returned by event_next() if nothing is pending
+#define EVENT_NONE  0xFF
+
+// Pending flags are kept in the general purpose I/O registers: events 0-7 in GPIOR0, 8-15 in GPIOR1, 16-23 in GPIOR2.
+// GPIOR0 is bit addressable, so posting one of the urgent events with a constant number is a single sbi instruction
+// and needs no interrupt lock.
+#define EVENT_FAST  8
+
+void     event_post_any( uint8_t event );
+void     event_cancel( uint8_t event );
+uint8_t  event_pending( uint8_t event );
+uint8_t  event_next( void );
+uint8_t  event_any( void );
+
+// Timer-scheduled events (in 10ms ticks of Timer 1, one pending timer per event)
+void     event_post_in( uint8_t event, uint16_t ticks );
+void     event_unschedule( uint8_t event );
+uint16_t event_scheduled( uint8_t event );
+void     event_tick( void );
+
+// Mark event as pending
+static inline void event_post( uint8_t event ) {
+    if ( __builtin_constant_p( event ) && ( event < EVENT_FAST ) ) {
+        GPIOR0 |= ( 1 << event );
+    }
+    else {
+        event_post_any( event );
+    }
+}
+
+#if EVENT_COUNT > 24
+    #error "Too many events, GPIOR0-2 hold 24!"
+#endif
+#endif
@@ -24,20 +24,29 @@
 #include <avr/eeprom.h>
 #include <util/delay.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 #include <avr/wdt.h>
 #include <avr/pgmspace.h>
 #include "portmakros.h"
 #include "timer.h"
 #include "eeprom.h"
+#include "settings.h"
 #include "crcchk.h"
+#include "shiftregister.h"
 #include "pyro.h"
+#include "slaves.h"
+#include "impreport.h"
+#include "blackbox.h"
+#include "memstat.h"
+#include "events.h"
+#include "idle.h"
+#include "prof.h"
 #include "leds.h"
 #include "addresses.h"
 #include "uart.h"
 #include "terminal.h"
 #include "adc.h"
 #include "lcd.h"
-#include "shiftregister.h"
 #include "1wire.h"
 
 #if RFM == 69
@@ -0,0 +1,75 @@
+/*
+ * idle.c
+ *
+ * Idle sleep between events and active duty cycle (see idle.h)
+ */
+
+#include "global.h"
+
+// Ticks slept (rest in microseconds) and ticks slept at the start of the window
+static volatile uint32_t idle_slept = 0, idle_window_start = 0;
+static volatile uint16_t idle_window = 0, idle_window_slept = 0;
+static uint16_t          idle_rest  = 0;
+
+// Active share in 0.1 % (both values get scaled down until the product fits into 32 bits)
+static uint16_t idle_share( uint32_t slept, uint32_t ticks ) {
+    while ( ticks >= ( 1UL << 22 ) ) {
+        ticks >>= 1;
+        slept >>= 1;
+    }
+
+    if ( !ticks ) {
+        return 1000;
+    }
+
+    if ( slept >= ticks ) {
+        return 0;
+    }
+
+    return 1000 - slept * 1000 / ticks;
+}
+
+// Sleep until the next interrupt, called with interrupts disabled (returns with interrupts disabled as well)
+void idle_sleep( void ) {
+    uint32_t start = clock_us(), slept;
+
+    // Wake up on UART reception (the ISR disables this again, the main loop polls the UART itself)
+    UCSR0B |= ( 1 << RXCIE0 );
+
+    set_sleep_mode( SLEEP_MODE_IDLE );
+    sleep_enable();
+    sei();
+    sleep_cpu(); // Executed before any pending interrupt, so no wake up can get lost
+    sleep_disable();
+    cli();
+
+    slept       = clock_us() - start + idle_rest;
+    idle_slept += slept / CLOCK_TICK_US;
+    idle_rest   = slept % CLOCK_TICK_US;
+}
+
+// Close the window (called by Timer 1 every 10ms)
+void idle_tick( void ) {
+    if ( ++idle_window >= IDLE_WINDOW ) {
+        idle_window       = 0;
+        idle_window_slept = idle_slept - idle_window_start;
+        idle_window_start = idle_slept;
+    }
+}
+
+// Current active shares
+void idle_read( idlestat_t *stat ) {
+    uint32_t ticks, slept;
+    uint16_t window_slept;
+    uint8_t  temp_sreg = SREG;
+
+    ticks        = clock_ticks();
+    cli();
+    slept        = idle_slept;
+    window_slept = idle_window_slept;
+    SREG         = temp_sreg;
+
+    stat->ticks  = ticks;
+    stat->active = idle_share( slept, ticks );
+    stat->recent = ( ticks < IDLE_WINDOW ) ? stat->active : idle_share( window_slept, IDLE_WINDOW );
+}
@@ -0,0 +1,31 @@
+/*
+ * idle.h
+ * Leerlauf: CPU schläft zwischen den Ereignissen, Anteil der aktiven Zeit (Duty-Cycle) als Kennzahl
+ */
+
+#ifndef IDLE_H_
+#define IDLE_H_
+
+/*
+ * The main loop calls idle_sleep() with interrupts disabled when no event is pending and nothing is waiting to be
+ * transferred. The CPU stays in idle mode (Timer 1 needs the I/O clock, so deeper modes would stop the 10ms tick)
+ * until the next interrupt: Timer 1 at the latest after 10ms (the radio module is polled then), UART reception,
+ * key switch, ADC, 1-Wire and EEPROM.
+ *
+ * The time slept is measured with the monotonic clock (timer.h) and compared to the elapsed ticks, active shares
+ * are given in 0.1 % (1000 = never slept).
+ */
+
+// Ticks (10ms) of the window for the recent active share (1 minute)
+#define IDLE_WINDOW 6000
+
+typedef struct {
+    uint32_t ticks;  // Elapsed ticks since start
+    uint16_t active; // Active share since start
+    uint16_t recent; // Active share within the last complete window (since start during the first one)
+} idlestat_t;
+
+void idle_sleep( void );
+void idle_tick( void );
+void idle_read( idlestat_t *stat );
+#endif
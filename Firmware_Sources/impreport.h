@@ -0,0 +1,106 @@
+/*
+ * impreport.h
+ * Kompakte Widerstandsberichte (IMPREPORT) mit Statusbitmap und geänderten, quantisierten Werten
+ */
+
+#ifndef IMPREPORT_H_
+#define IMPREPORT_H_
+
+/*
+ * Frame layout:
+ *
+ * [0]                 IMPREPORT
+ * [1]                 Unique-ID
+ * [2]                 Number of channels (bits 0-5), IMPREPORT_FULL (bit 7)
+ * [3 ...]             Status bitmap, bit set = channel below IMPREPORT_LIMIT (bit 0 of first byte = channel 1)
+ * [3 + bytes ...]     Change bitmap, bit set = quantized value of channel follows
+ * [3 + 2 * bytes ...] Quantized values of the marked channels, two per byte (lower nibble first)
+ * [last]              Number of repetitions (as for every message)
+ *
+ * The status bitmap is always complete, so continuity stays right even if a report gets lost.
+ * Values are only sent when their quantized value changed since the last report, every
+ * IMPREPORT_REFRESH-th report (and the first one after a reset) carries all of them.
+ */
+
+// Maximum number of channels within a report (boxes with more channels report the first 32)
+#define IMPREPORT_MAX_CHANNELS 32
+
+#if SR_CHANNELS > IMPREPORT_MAX_CHANNELS
+    #define IMPREPORT_CHANNELS IMPREPORT_MAX_CHANNELS
+#else
+    #define IMPREPORT_CHANNELS SR_CHANNELS
+#endif
+
+// Bytes of a bitmap
+#define IMPREPORT_BYTES( CH )  ( ( ( CH ) + 7 ) / 8 )
+
+// Impedances from this value on count as open (same as status LEDs and impedance list)
+#define IMPREPORT_LIMIT        50
+
+// Ohms per quantization step, quantized value IMPREPORT_OPEN marks an open channel
+#define IMPREPORT_STEP         4
+#define IMPREPORT_OPEN         0x0F
+
+// Flag in byte 2: report carries the values of all channels
+#define IMPREPORT_FULL         0x80
+
+// Every n-th report carries the values of all channels
+#define IMPREPORT_REFRESH      8
+
+// Sweep (MEASURE to unique-id 0): boxes reply after the longest possible scan, each one in its own slot
+// according to its unique-id (10ms ticks, a full report sent twice takes about 70ms at 9600 baud)
+#define IMPREPORT_SWEEP_OFFSET ( 2 * IMPREPORT_MAX_CHANNELS + 10 )
+#define IMPREPORT_SWEEP_SLOT   10
+
+// Maximum message length (including the byte for the number of repetitions)
+#define IMPREPORT_MAX_LENGTH   ( 3 + 2 * IMPREPORT_BYTES( IMPREPORT_MAX_CHANNELS ) + IMPREPORT_MAX_CHANNELS / 2 + 1 )
+
+#if IMPREPORT_MAX_LENGTH > ( MAX_COM_ARRAYSIZE - 1 )
+    #error "IMPREPORT does not fit into the communication array!"
+#endif
+
+// Quantized values of the last report, kept by the reporting box
+typedef struct {
+    uint8_t values[( IMPREPORT_CHANNELS + 1 ) / 2];
+    uint8_t count;                          // Reports since the last full one
+} impreport_t;
+
+// Maximum number of boxes in the sweep table, only boxes that replied take space. An entry holds a report of
+// any size (22 bytes), so at most 32 boxes are kept by default (-DIMPTABLE_MAX=... to change)
+#ifndef IMPTABLE_MAX
+    #if SLAVES_MAX > 32
+        #define IMPTABLE_MAX 32
+    #else
+        #define IMPTABLE_MAX SLAVES_MAX
+    #endif
+#endif
+
+#if IMPTABLE_MAX > 254
+    #error "IMPTABLE_MAX is too big!"
+#endif
+
+// Continuity and quantized values of the channels of a box, kept by the transmitter. Sized for the largest report,
+// not for the channels of the transmitter itself. The values follow the reports of the box: a full report replaces
+// all of them, the others only the changed ones, IMPREPORT_OPEN stands for open or not yet known.
+typedef struct {
+    uint8_t unique_id;
+    uint8_t channels;                                           // Number of channels of the last report, 0 = no reply to the last sweep
+    uint8_t status[IMPREPORT_BYTES( IMPREPORT_MAX_CHANNELS )];  // Bit set = channel below IMPREPORT_LIMIT (bit 0 of first byte = channel 1)
+    uint8_t values[IMPREPORT_MAX_CHANNELS / 2];                 // Quantized values, two per byte (lower nibble first)
+} impentry_t;
+
+// Boxes that ever replied, sorted by Unique-ID (kept over sweeps, the boxes only send changed values)
+typedef struct {
+    impentry_t box[IMPTABLE_MAX];
+    uint8_t    count;                                       // Boxes in box[]
+    uint8_t    dropped;                                     // Reports not entered because the table was full
+} imptable_t;
+
+uint8_t impreport_quantize( const uint8_t impedance );
+uint8_t impreport_encode( char *frame, const uint8_t uid, const uint8_t *impedances, impreport_t *last );
+uint8_t impreport_length( const char *frame );
+uint8_t impreport_count( const char *frame );
+uint8_t     impreport_value( const impentry_t *entry, const uint8_t ch );
+void        impreport_restart( imptable_t *table );
+impentry_t *impreport_store( imptable_t *table, const char *frame );
+#endif
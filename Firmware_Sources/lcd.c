@@ -7,6 +7,15 @@
 
 #include "global.h"
 
+// Shadow framebuffer: writers only change RAM, lcd_flush() transfers changed cells to the display
+static char    lcd_fb[LINES * COLUMNS];
+static uint8_t lcd_dirty[( LINES * COLUMNS + 7 ) / 8];
+static uint8_t lcd_ndirty = 0;  // Number of changed cells
+static uint8_t lcd_pos    = 0;  // Cursor of the writers (index in lcd_fb)
+static uint8_t lcd_hwpos  = 0;  // Cursor of the display, LCD_POS_UNKNOWN after commands
+static uint8_t lcd_next   = 0;  // Cell to continue flushing with
+static uint8_t lcd_active = 0;  // Display has been initialised
+
 // Apply data
 static void lcd_enable( void ) {
     E_HIGH;
@@ -15,9 +24,18 @@ static void lcd_enable( void ) {
     E_LOW;
 }
 
+static uint8_t lcd_status( uint16_t tries );
+
 // Wait for busy flag
 static void lcd_busycheck( void ) {
-    lcd_cursorread();
+    lcd_status( 9999 );
+}
+
+// DDRAM address of a cell of the framebuffer
+static uint8_t lcd_address( uint8_t pos ) {
+    uint8_t zeile = pos / COLUMNS;
+
+    return ( ( zeile & 1 ) << 6 ) + ( zeile >> 1 ) * COLUMNS + pos % COLUMNS;
 }
 
 // Clear data bits
@@ -134,6 +152,8 @@ static void lcd_transfer( uint8_t data ) {
 
 // Write data to CGRAM (e.g. symbol definitions)
 void lcd_cgwrite( uint8_t data ) {
+    lcd_busycheck();
+
     SCHREIBEN;
     DATENMODUS;
 
@@ -142,62 +162,117 @@ void lcd_cgwrite( uint8_t data ) {
     lcd_busycheck();
 }
 
-// Send data or order to LCD
+// Send order to LCD or write character to the framebuffer at the cursor position
 void lcd_send( uint8_t data, uint8_t dat ) {
-    SCHREIBEN;
+    if ( dat ) {
+        if ( lcd_fb[lcd_pos] != (char) data ) {
+            lcd_fb[lcd_pos] = data;
 
-    // Daten- (1) oder Befehlsmodus (0)
-    if ( !dat ) {
-        BEFEHLSMODUS;
-    }
+            if ( !( lcd_dirty[lcd_pos >> 3] & ( 1 << ( lcd_pos & 7 ) ) ) ) {
+                lcd_dirty[lcd_pos >> 3] |= 1 << ( lcd_pos & 7 );
+                lcd_ndirty++;
+            }
+        }
 
-    if ( dat ) {
-        DATENMODUS;
+        // Continue with the next line after the last column, first line after the last one
+        if ( ++lcd_pos >= LINES * COLUMNS ) {
+            lcd_pos = 0;
+        }
+
+        return;
     }
 
+    lcd_busycheck();
+
+    SCHREIBEN;
+    BEFEHLSMODUS;
+
     lcd_transfer( data );
 
     lcd_busycheck();
 
-    if ( dat ) {
-        uint8_t posi = lcd_cursorread();
+    lcd_hwpos = LCD_POS_UNKNOWN;
+}
 
-        switch ( posi ) {
-            case ( COLUMNS ): {
-                lcd_cursorset( 2, 1 );
-                break;
-            }
+// Clear LCD screen (display and framebuffer)
+void lcd_clear( void ) {
+    lcd_send( 1 << 0, 0 );
 
-            case ( 64 + COLUMNS ): {
-                lcd_cursorset( 3, 1 );
-                break;
-            }
+    for ( uint8_t i = 0; i < LINES * COLUMNS; i++ ) {
+        lcd_fb[i] = ' ';
+    }
 
-            case ( 64 ): {
-                lcd_cursorset( 4, 1 );
-                break;
-            }
+    for ( uint8_t i = 0; i < sizeof( lcd_dirty ); i++ ) {
+        lcd_dirty[i] = 0;
+    }
 
-            case ( 64 + 2 * COLUMNS ): {
-                lcd_cursorset( 1, 1 );
-                break;
-            }
+    lcd_ndirty = 0;
+    lcd_pos    = 0;
+    lcd_hwpos  = 0;
+}
+
+// Set cursor to first line and first column
+void lcd_cursorhome( void ) {
+    lcd_pos = 0;
+}
+
+// Transfer up to cells changed cells (or cursor movements) to the display. Never waits for the display:
+// if it is still busy with the last transfer, the rest is left for the next call.
+void lcd_flush( uint8_t cells ) {
+    if ( !lcd_active ) {
+        return;
+    }
+
+    for ( uint8_t n = LINES * COLUMNS; lcd_ndirty && cells && n; n-- ) {
+        uint8_t pos = lcd_next;
 
-            default: {
-                break;
+        if ( !( lcd_dirty[pos >> 3] & ( 1 << ( pos & 7 ) ) ) ) {
+            if ( ++lcd_next >= LINES * COLUMNS ) {
+                lcd_next = 0;
             }
+
+            continue;
+        }
+
+        if ( lcd_status( 0 ) & ( 1 << 7 ) ) {
+            return;
         }
+
+        cells--;
+        SCHREIBEN;
+
+        // Move cursor of the display first, the cell is sent during the next pass
+        if ( lcd_hwpos != pos ) {
+            BEFEHLSMODUS;
+            lcd_transfer( ( 1 << 7 ) | lcd_address( pos ) );
+            lcd_hwpos = pos;
+            n++;
+            continue;
+        }
+
+        DATENMODUS;
+        lcd_transfer( lcd_fb[pos] );
+
+        lcd_dirty[pos >> 3] &= ~( 1 << ( pos & 7 ) );
+        lcd_ndirty--;
+
+        // The display continues within the line only
+        lcd_hwpos = ( ( pos % COLUMNS ) == ( COLUMNS - 1 ) ) ? LCD_POS_UNKNOWN : pos + 1;
+        lcd_next  = ( pos + 1 < LINES * COLUMNS ) ? pos + 1 : 0;
     }
 }
 
-// Clear LCD screen
-void lcd_clear( void ) {
-    lcd_send( 1 << 0, 0 );
+// Changed cells waiting to be transferred
+uint8_t lcd_pending( void ) {
+    return lcd_active && lcd_ndirty;
 }
 
-// Set cursor to first line and first column
-void lcd_cursorhome( void ) {
-    lcd_send( 1 << 1, 0 );
+// Transfer all changed cells, waits for the display (e.g. before a reset)
+void lcd_flush_all( void ) {
+    while ( lcd_active && lcd_ndirty ) {
+        lcd_busycheck();
+        lcd_flush( LINES * COLUMNS );
+    }
 }
 
 // Read-out address pins
@@ -235,10 +310,9 @@ static uint8_t lcd_getaddr() {
     return addr;
 }
 
-// Read current cursor position
-uint8_t lcd_cursorread() {
-    uint8_t  addr   = 0x80;
-    uint16_t utimer = 10000;
+// Read busy flag and address counter, retries up to tries times while the display is busy
+static uint8_t lcd_status( uint16_t tries ) {
+    uint8_t addr;
 
     // Datenleitungswerte zwischenspeichern
     uint8_t zwsp = 0;
@@ -273,7 +347,9 @@ uint8_t lcd_cursorread() {
     BEFEHLSMODUS;
     LESEN;
 
-    while ( --utimer && ( addr & ( 1 << 7 ) ) ) addr = lcd_getaddr();
+    addr = lcd_getaddr();
+
+    while ( tries-- && ( addr & ( 1 << 7 ) ) ) addr = lcd_getaddr();
 
     SCHREIBEN;
 
@@ -328,13 +404,16 @@ uint8_t lcd_cursorread() {
         DB7PORT |= 1 << DB7;
     }
 
-    return addr & 0x7F;
+    return addr;
+}
+
+// Read current cursor position of the display
+uint8_t lcd_cursorread() {
+    return lcd_status( 9999 ) & 0x7F;
 }
 
 // Set cursor position
 void lcd_cursorset( uint8_t zeile, uint8_t spalte ) {
-    uint8_t numbr;
-
     if ( zeile > LINES ) {
         zeile = 1;
     }
@@ -343,16 +422,7 @@ void lcd_cursorset( uint8_t zeile, uint8_t spalte ) {
         spalte = 1;
     }
 
-    uint8_t zmult  = ( 1 - ( zeile & 1 ) );
-    uint8_t spmult = ( ( zeile - 1 ) >> 1 );
-    numbr = ( ( 1 << 7 ) + ( zmult << 6 ) + ( spmult << 4 ) + ( spmult << 2 ) + spalte - 1 );
-
-    SCHREIBEN;
-    BEFEHLSMODUS;
-
-    lcd_transfer( numbr );
-
-    lcd_busycheck();
+    lcd_pos = ( zeile - 1 ) * COLUMNS + spalte - 1;
 }
 
 // Display String
@@ -447,4 +517,6 @@ void lcd_init( void ) {
 
     // Display löschen
     lcd_clear();
+
+    lcd_active = 1;
 }
\ No newline at end of file
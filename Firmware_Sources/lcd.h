@@ -17,6 +17,9 @@
 #define   LINES        4
 #define   COLUMNS      20
 
+// Max. number of cells transferred per call of lcd_flush() from the main loop
+#define   LCD_FLUSH_CELLS 4
+
 // Connections
 #define   RS_PORT      D
 #define   RS_NUM       4
@@ -101,6 +104,8 @@
     #define   DB3      DB3_NUM
 #endif
 
+#define   LCD_POS_UNKNOWN 0xFF
+
 // Makros
 #define   BEFEHLSMODUS RSPORT &= ~( 1 << RS )
 #define   DATENMODUS   RSPORT |= ( 1 << RS )
@@ -119,6 +124,9 @@ void lcd_send( uint8_t data, uint8_t dat );
 void lcd_puts( char *strin );
 void lcd_clear( void );
 void lcd_cursorhome( void );
+void lcd_flush( uint8_t cells );
+void lcd_flush_all( void );
+uint8_t lcd_pending( void );
 void lcd_arrize( int32_t zahl, char *feld, uint8_t digits, uint8_t vorzeichen );
 // uint8_t lcd_getaddr(void);
 uint8_t lcd_cursorread( void );
@@ -7,66 +7,223 @@
 
 #include "global.h"
 
+/*
+ * LEDs switched with the led_...() functions form the base layer. Patterns are shown on top of it (only the LEDs
+ * within their mask), a higher priority on top of a lower one. leds_tick() advances the patterns every 10ms
+ * (Timer 1), so nobody has to wait for a pattern to finish.
+ */
+typedef struct {
+    const led_step_t *steps;
+    uint8_t           count;  // Number of steps, 0: slot unused
+    uint8_t           mask;   // LEDs controlled by the pattern
+    uint8_t           repeat; // Remaining repetitions
+    uint8_t           pos;    // Current step
+    uint8_t           left;   // Remaining ticks of the current step
+} led_slot_t;
+
+static volatile uint8_t leds_base = 0;
+static led_slot_t       leds_slots[LED_PRIOS];
+static led_step_t       leds_flash_step, leds_id_steps[LED_ID_STEPS];
+
+// Write base layer with all patterns on top of it to the LEDs
+static void leds_output( void ) {
+    uint8_t leds = leds_base;
+
+    for ( uint8_t i = 0; i < LED_PRIOS; i++ ) {
+        if ( leds_slots[i].count ) {
+            leds = ( leds & ~leds_slots[i].mask ) | ( leds_slots[i].steps[leds_slots[i].pos].leds & leds_slots[i].mask );
+        }
+    }
+
+    if ( leds & LED_YELLOW ) {
+        LED_YELLOW_PORT |= 1 << LED_YELLOW_POS;
+    }
+    else {
+        LED_YELLOW_PORT &= ~( 1 << LED_YELLOW_POS );
+    }
+
+    if ( leds & LED_GREEN ) {
+        LED_GREEN_PORT |= 1 << LED_GREEN_POS;
+    }
+    else {
+        LED_GREEN_PORT &= ~( 1 << LED_GREEN_POS );
+    }
+
+    if ( leds & LED_ORANGE ) {
+        LED_ORANGE_PORT |= 1 << LED_ORANGE_POS;
+    }
+    else {
+        LED_ORANGE_PORT &= ~( 1 << LED_ORANGE_POS );
+    }
+
+    if ( leds & LED_RED ) {
+        LED_RED_PORT |= 1 << LED_RED_POS;
+    }
+    else {
+        LED_RED_PORT &= ~( 1 << LED_RED_POS );
+    }
+}
+
+// Change base layer
+static void leds_update( uint8_t leds ) {
+    uint8_t sreg = SREG;
+    cli();
+    leds_base = leds;
+    leds_output();
+    SREG = sreg;
+}
+
+// Show pattern with the given priority (replaces the one shown so far), it runs repeat + 1 times
+void leds_play( uint8_t prio, const led_step_t *steps, uint8_t count, uint8_t mask, uint8_t repeat ) {
+    uint8_t sreg = SREG;
+    cli();
+    leds_slots[prio].steps  = steps;
+    leds_slots[prio].count  = count;
+    leds_slots[prio].mask   = mask;
+    leds_slots[prio].repeat = repeat;
+    leds_slots[prio].pos    = 0;
+    leds_slots[prio].left   = steps[0].ticks;
+    leds_output();
+    SREG = sreg;
+}
+
+// Stop pattern with the given priority
+void leds_cancel( uint8_t prio ) {
+    uint8_t sreg = SREG;
+    cli();
+    leds_slots[prio].count = 0;
+    leds_output();
+    SREG = sreg;
+}
+
+// Flash LEDs once for a number of 10ms ticks
+void leds_flash( uint8_t leds, uint8_t ticks ) {
+    uint8_t sreg = SREG;
+    cli();
+    leds_flash_step.leds  = leds;
+    leds_flash_step.ticks = ticks;
+    leds_play( LED_PRIO_STATUS, &leds_flash_step, 1, leds, 0 );
+    SREG = sreg;
+}
+
+// Add step to the slave-ID display
+static uint8_t leds_id_step( uint8_t n, uint8_t leds, uint8_t ticks ) {
+    leds_id_steps[n].leds  = leds;
+    leds_id_steps[n].ticks = ticks;
+    return n + 1;
+}
+
+// Show slave-ID: running light, upper nibble for 2s, running light backwards, lower nibble for 2s
+void leds_show_id( uint8_t id ) {
+    uint8_t n = 0;
+
+    for ( uint8_t nibble = 0; nibble < 2; nibble++ ) {
+        uint8_t run = 0;
+
+        n = leds_id_step( n, 0, 15 );
+
+        for ( uint8_t i = 0; i < 4; i++ ) {
+            run |= nibble ? ( LED_RED >> i ) : ( LED_YELLOW << i );
+            n    = leds_id_step( n, run, 15 );
+        }
+
+        n = leds_id_step( n, 0, 25 );
+        n = leds_id_step( n, nibble ? ( id & 0x0F ) : ( id >> 4 ), 200 );
+    }
+
+    n = leds_id_step( n, 0, 20 );
+
+    leds_play( LED_PRIO_ID, leds_id_steps, n, LEDS_ALL, 0 );
+}
+
+// Advance patterns (Timer 1, every 10ms)
+void leds_tick( void ) {
+    uint8_t changed = 0;
+
+    for ( uint8_t i = 0; i < LED_PRIOS; i++ ) {
+        led_slot_t *slot = &leds_slots[i];
+
+        if ( !slot->count || --slot->left ) {
+            continue;
+        }
+
+        changed = 1;
+
+        if ( ++slot->pos >= slot->count ) {
+            slot->pos = 0;
+
+            if ( !slot->repeat ) {
+                slot->count = 0;
+                continue;
+            }
+
+            if ( slot->repeat != LED_ENDLESS ) {
+                slot->repeat--;
+            }
+        }
+
+        slot->left = slot->steps[slot->pos].ticks;
+    }
+
+    if ( changed ) {
+        leds_output();
+    }
+}
+
 void led_yellow_on( void ) {
-    LED_YELLOW_PORT |= 1 << LED_YELLOW_POS;
+    leds_update( leds_base | LED_YELLOW );
 }
 
 void led_yellow_toggle( void ) {
-    LED_YELLOW_PIN = 1 << LED_YELLOW_POS;
+    leds_update( leds_base ^ LED_YELLOW );
 }
 
 void led_yellow_off( void ) {
-    LED_YELLOW_PORT &= ~( 1 << LED_YELLOW_POS );
+    leds_update( leds_base & ~LED_YELLOW );
 }
 
 void led_red_on( void ) {
-    LED_RED_PORT |= 1 << LED_RED_POS;
+    leds_update( leds_base | LED_RED );
 }
 
 void led_red_toggle( void ) {
-    LED_RED_PIN = 1 << LED_RED_POS;
+    leds_update( leds_base ^ LED_RED );
 }
 
 void led_red_off( void ) {
-    LED_RED_PORT &= ~( 1 << LED_RED_POS );
+    leds_update( leds_base & ~LED_RED );
 }
 
 void led_green_on( void ) {
-    LED_GREEN_PORT |= 1 << LED_GREEN_POS;
+    leds_update( leds_base | LED_GREEN );
 }
 
 void led_green_toggle( void ) {
-    LED_GREEN_PIN = 1 << LED_GREEN_POS;
+    leds_update( leds_base ^ LED_GREEN );
 }
 
 void led_green_off( void ) {
-    LED_GREEN_PORT &= ~( 1 << LED_GREEN_POS );
+    leds_update( leds_base & ~LED_GREEN );
 }
 
 void led_orange_on( void ) {
-    LED_ORANGE_PORT |= 1 << LED_ORANGE_POS;
+    leds_update( leds_base | LED_ORANGE );
 }
 
 void led_orange_toggle( void ) {
-    LED_ORANGE_PIN = 1 << LED_ORANGE_POS;
+    leds_update( leds_base ^ LED_ORANGE );
 }
 
 void led_orange_off( void ) {
-    LED_ORANGE_PORT &= ~( 1 << LED_ORANGE_POS );
+    leds_update( leds_base & ~LED_ORANGE );
 }
 
 void leds_off( void ) {
-    LED_ORANGE_PORT &= ~( 1 << LED_ORANGE_POS );
-    LED_GREEN_PORT  &= ~( 1 << LED_GREEN_POS );
-    LED_RED_PORT    &= ~( 1 << LED_RED_POS );
-    LED_YELLOW_PORT &= ~( 1 << LED_YELLOW_POS );
+    leds_update( 0 );
 }
 
 void leds_on( void ) {
-    LED_ORANGE_PORT |= ( 1 << LED_ORANGE_POS );
-    LED_GREEN_PORT  |= ( 1 << LED_GREEN_POS );
-    LED_RED_PORT    |= ( 1 << LED_RED_POS );
-    LED_YELLOW_PORT |= ( 1 << LED_YELLOW_POS );
+    leds_update( LEDS_ALL );
 }
 
 uint8_t leds_status( void ) {
@@ -16,8 +16,35 @@
 #define LED_ORANGE_P   D
 #define LED_ORANGE_NUM 5
 
+// Duration of a status flash (10ms ticks)
+#define LED_FLASH_TICKS 5
+
 // DO NOT CHANGE ANYTHING BELOW THIS LINE
 
+// LEDs as bits of a pattern step (same order as leds_status())
+#define LED_YELLOW      0x01
+#define LED_GREEN       0x02
+#define LED_ORANGE      0x04
+#define LED_RED         0x08
+#define LEDS_ALL        0x0F
+
+// Pattern slots, a higher priority is shown on top of a lower one
+#define LED_PRIO_STATUS 0 // Short flashes for status indications
+#define LED_PRIO_ID     1 // Slave-ID at startup
+#define LED_PRIOS       2
+
+// Repeat pattern until leds_cancel()
+#define LED_ENDLESS     0xFF
+
+// Steps of the slave-ID display
+#define LED_ID_STEPS    15
+
+// Step of a pattern: LEDs on (within the mask of the pattern) for a number of 10ms ticks (at least 1)
+typedef struct {
+    uint8_t leds;
+    uint8_t ticks;
+} led_step_t;
+
 void led_yellow_on( void );
 void led_yellow_off( void );
 void led_yellow_toggle( void );
@@ -34,6 +61,11 @@ void led_init( void );
 void leds_off( void );
 void leds_on( void );
 uint8_t leds_status( void );
+void leds_play( uint8_t prio, const led_step_t *steps, uint8_t count, uint8_t mask, uint8_t repeat );
+void leds_cancel( uint8_t prio );
+void leds_flash( uint8_t leds, uint8_t ticks );
+void leds_show_id( uint8_t id );
+void leds_tick( void );
 
 #define LED_YELLOW_PORT PORT( LED_YELLOW_P )
 #define LED_YELLOW_PIN  PIN( LED_YELLOW_P )
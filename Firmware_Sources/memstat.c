@@ -0,0 +1,69 @@
+/*
+ * memstat.c
+ *
+ * Stack high-water mark and RAM usage (see memstat.h)
+ */
+
+#include "global.h"
+
+// Symbols of the linker script: start of .data, end of .bss
+extern uint8_t __data_start, _end;
+
+// Fill free RAM with the pattern (called from .init3, the stack is still empty)
+void memstat_paint( void ) {
+    for ( uint8_t *p = &_end; p < (uint8_t *)(uintptr_t) SP; p++ ) {
+        *p = MEMSTAT_PAINT;
+    }
+}
+
+// Current RAM usage and active shares
+void memstat_read( memstat_t *stat ) {
+    const uint8_t *p = &_end;
+    idlestat_t     idle;
+
+    // The first byte without the pattern is the deepest point the stack has reached
+    while ( ( p < (const uint8_t *)(uintptr_t) SP ) && ( *p == MEMSTAT_PAINT ) ) {
+        p++;
+    }
+
+    stat->data     = &_end - &__data_start;
+    stat->free     = p - &_end;
+    stat->stack    = RAMEND + 1 - (uintptr_t) p;
+    stat->free_now = SP - (uintptr_t) &_end;
+
+    idle_read( &idle );
+    stat->active = idle.active;
+    stat->recent = idle.recent;
+}
+
+// Build MEMREPORT message (fixed length MEMREPORT_LENGTH)
+void memstat_to_frame( char *frame, const uint8_t uid ) {
+    memstat_t stat;
+
+    memstat_read( &stat );
+
+    frame[0]  = MEMREPORT;
+    frame[1]  = uid;
+    frame[2]  = stat.data & 0xFF;
+    frame[3]  = stat.data >> 8;
+    frame[4]  = stat.stack & 0xFF;
+    frame[5]  = stat.stack >> 8;
+    frame[6]  = stat.free & 0xFF;
+    frame[7]  = stat.free >> 8;
+    frame[8]  = stat.free_now & 0xFF;
+    frame[9]  = stat.free_now >> 8;
+    frame[10] = stat.active & 0xFF;
+    frame[11] = stat.active >> 8;
+    frame[12] = stat.recent & 0xFF;
+    frame[13] = stat.recent >> 8;
+}
+
+// Values of a received MEMREPORT message
+void memstat_from_frame( const char *frame, memstat_t *stat ) {
+    stat->data     = (uint8_t) frame[2] | ( (uint16_t)(uint8_t) frame[3] << 8 );
+    stat->stack    = (uint8_t) frame[4] | ( (uint16_t)(uint8_t) frame[5] << 8 );
+    stat->free     = (uint8_t) frame[6] | ( (uint16_t)(uint8_t) frame[7] << 8 );
+    stat->free_now = (uint8_t) frame[8] | ( (uint16_t)(uint8_t) frame[9] << 8 );
+    stat->active   = (uint8_t) frame[10] | ( (uint16_t)(uint8_t) frame[11] << 8 );
+    stat->recent   = (uint8_t) frame[12] | ( (uint16_t)(uint8_t) frame[13] << 8 );
+}
@@ -0,0 +1,96 @@
+/*
+ * prof.c
+ *
+ * Section profiler for the main loop and the radio module (see prof.h)
+ */
+
+#include "global.h"
+
+#if PROFILING
+
+static profstat_t prof_stats[PROF_SECTIONS]; // Durations in counts of Timer 1
+
+// Section of a main-loop event, PROF_SECTIONS if nothing was handled
+uint8_t prof_section( uint8_t event ) {
+    switch ( event ) {
+        case EV_UART:
+        case EV_CONFIG:
+        case EV_REMOTE:
+        case EV_SEND:
+        case EV_HW: {
+            return PROF_UART;
+        }
+
+        case EV_TRANSMIT: {
+            return PROF_TRANSMIT;
+        }
+
+        case EV_FIRE: {
+            return PROF_FIRE;
+        }
+
+        case EV_PULSE: {
+            return PROF_PULSE;
+        }
+
+        case EV_RECEIVE: {
+            return PROF_RECEIVE;
+        }
+
+        case EV_LCD_TX:
+        case EV_LCD_RX:
+        case EV_LCD_CLEAR: {
+            return PROF_LCD;
+        }
+
+        case EVENT_NONE: {
+            return PROF_SECTIONS;
+        }
+
+        default: {
+            return PROF_OTHER;
+        }
+    }
+}
+
+// Add a run of a section that started at start (counts of Timer 1)
+void prof_add( uint8_t section, uint32_t start ) {
+    uint32_t    duration = clock_counts() - start;
+    profstat_t *stat;
+
+    if ( section >= PROF_SECTIONS ) {
+        return;
+    }
+
+    stat = &prof_stats[section];
+
+    if ( !stat->count || ( duration < stat->min ) ) {
+        stat->min = duration;
+    }
+
+    if ( duration > stat->max ) {
+        stat->max = duration;
+    }
+
+    stat->count++;
+    stat->total += duration;
+}
+
+// Statistics of a section in us
+void prof_read( uint8_t section, profstat_t *stat ) {
+    stat->count = prof_stats[section].count;
+    stat->total = clock_counts_us( prof_stats[section].total );
+    stat->min   = clock_counts_us( prof_stats[section].min );
+    stat->max   = clock_counts_us( prof_stats[section].max );
+}
+
+// Start over
+void prof_reset( void ) {
+    for ( uint8_t i = 0; i < PROF_SECTIONS; i++ ) {
+        prof_stats[i].count = 0;
+        prof_stats[i].total = 0;
+        prof_stats[i].min   = 0;
+        prof_stats[i].max   = 0;
+    }
+}
+#endif
@@ -0,0 +1,53 @@
+/*
+ * prof.h
+ * Laufzeitmessung (Profiling) der Abschnitte der Hauptschleife und des Funkverkehrs, nur im Profiling-Build
+ */
+
+#ifndef PROF_H_
+#define PROF_H_
+
+// Profiling build (-DPROFILING=1, see Hexfiles/build_hexfiles.bat), compiled out otherwise
+#ifndef PROFILING
+    #define PROFILING 0
+#endif
+
+/*
+ * PROF_START() takes a timestamp in counts of Timer 1 (about 0.8us) from the monotonic clock, PROF_STOP() adds the
+ * duration to the runs, total, minimum and maximum of a section. Sections of the main loop are assigned by the
+ * event that was handled, so every break out of a case gets measured. rfm_transmit() and rfm_receive() are
+ * measured on their own and are contained in the section of the event that called them. The polling before the
+ * events is a section of its own, lcd_flush() (all bus transfers to the LCD) is counted as LCD.
+ */
+#define PROF_UART     0 // UART commands and menus
+#define PROF_TRANSMIT 1 // Transmission process
+#define PROF_FIRE     2 // Switch on a channel
+#define PROF_PULSE    3 // Monitor ignition pulses
+#define PROF_RECEIVE  4 // Received radio message
+#define PROF_LCD      5 // Refresh and clear LCD
+#define PROF_OTHER    6 // All other events
+#define PROF_RFM_TX   7 // rfm_transmit()
+#define PROF_RFM_RX   8 // rfm_receive()
+#define PROF_POLL     9 // Polling at the top of the main loop (UART, radio, transmit slot, event log)
+#define PROF_SECTIONS 10
+
+// Statistics of a section (durations in us)
+typedef struct {
+    uint32_t count;
+    uint32_t total;
+    uint32_t min;
+    uint32_t max;
+} profstat_t;
+
+#if PROFILING
+    #define PROF_START( NAME )         uint32_t NAME = clock_counts()
+    #define PROF_STOP( SECTION, NAME ) prof_add( SECTION, NAME )
+
+    uint8_t prof_section( uint8_t event );
+    void    prof_add( uint8_t section, uint32_t start );
+    void    prof_read( uint8_t section, profstat_t *stat );
+    void    prof_reset( void );
+#else
+    #define PROF_START( NAME )
+    #define PROF_STOP( SECTION, NAME )
+#endif
+#endif
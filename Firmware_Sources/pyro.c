@@ -10,8 +10,19 @@
 #include "global.h"
 
 // Global Variables
-static volatile uint8_t  timer1_flags = 0, channel_monitor = 0, key_flag = 0, clear_lcd_tx_flag = 0, clear_lcd_rx_flag = 0;
-static volatile uint16_t transmit_flag = 0, hist_del_flag = 0, active_channels = 0;
+static volatile uint8_t  clear_lcd_tx_flag = 0, clear_lcd_rx_flag = 0;
+static volatile uint16_t  hist_del_flag   = 0;
+static volatile uint16_t  status_ticks    = 0, status_holdoff = 0;
+static volatile uint8_t   status_sample   = 0;
+static volatile chanset_t active_channels = 0;
+
+// Temperature measurement: ROM-IDs found at startup, scratchpad and bus transactions (configuration and
+// conversion for all sensors, readout of one sensor after the other)
+static uint8_t      temp_ids[TEMP_SENSORS][8], temp_sensors = 0, temp_index = 0;
+static uint8_t      temp_pad[9];
+static w1_request_t temp_conf_req = { WRITE, NULL, temp_pad, 3, 0, EVENT_NONE, 0, 0, 0, 0 };
+static w1_request_t temp_conv_req = { CONVERT_T, NULL, NULL, 0, 0, EVENT_NONE, 0, 0, 0, 0 };
+static w1_request_t temp_read_req = { READ, NULL, temp_pad, 0, 9, EV_TEMP, 0, 0, 0, 0 };
 
 void wdt_init( void ) {
     MCUSR = 0;
@@ -19,22 +30,18 @@ void wdt_init( void ) {
     return;
 }
 
-// Initialise Key-Switch
+// Key switch: last samples (bit set = contact open), debounced state (1 = closed = armed), sampling active
+static volatile uint8_t key_history = 0x55, key_closed = 0, key_enabled = 0;
+
+// Initialise Key-Switch (Timer 1 samples it from now on)
 void key_init( void ) {
     KEY_PORT |= ( 1 << KEY );
     KEY_DDR  &= ~( 1 << KEY );
 
-    // Activate Pin-Change Interrupt
-    #if ( KEY_NUMERIC == BPORT )
-        PCICR  |= ( 1 << PCIE0 );
-        PCMSK0 |= ( 1 << KEY );
-    #elif ( KEY_NUMERIC == DPORT )
-        PCICR  |= ( 1 << PCIE2 );
-        PCMSK2 |= ( 1 << KEY );
-    #else
-        PCICR  |= ( 1 << PCIE1 );
-        PCMSK1 |= ( 1 << KEY );
-    #endif
+    key_history = 0x55;
+    key_closed  = 0;
+    key_enabled = 1;
+
     // Keep low-impedance path between ignition voltage and clamps closed
     MOSSWITCHPORT &= ~( 1 << MOSSWITCH );
     MOSSWITCHDDR  |= ( 1 << MOSSWITCH );
@@ -45,50 +52,41 @@ void key_deinit( void ) {
     KEY_PORT &= ~( 1 << KEY );
     KEY_DDR  &= ~( 1 << KEY );
 
-    // Deactivate Pin-Change Interrupt
-    #if ( KEY_NUMERIC == BPORT )
-        PCICR  &= ~( 1 << PCIE0 );
-        PCMSK0 &= ~( 1 << KEY );
-    #elif ( KEY_NUMERIC == DPORT )
-        PCICR  &= ~( 1 << PCIE2 );
-        PCMSK2 &= ~( 1 << KEY );
-    #else
-        PCICR  &= ~( 1 << PCIE1 );
-        PCMSK1 &= ~( 1 << KEY );
-    #endif
+    key_enabled = 0;
 }
 
-// Switch debouncing
-uint8_t debounce( volatile uint8_t *port, uint8_t pin ) {
-    uint8_t keystate = 0x55, ctr = 0, timer0_regb = TCCR0B;
-
-    // Reset Timer 0
-    TCNT0  = 0;
-    TIFR0  = ( 1 << TOV0 );
-    TCNT0  = 160;
-    TCCR0B = ( 1 << CS02 | 1 << CS00 );
-
-    // Query switch state every 10 ms until 8 identical states in a row are received
-    while ( ( ( keystate != 0x00 ) && ( keystate != 0xFF ) ) || ( ctr < 8 ) ) {
-        keystate <<= 1;                                // Shift left
-        keystate  |= ( ( *port & ( 1 << pin ) ) > 0 ); // Write 0 or 1 to LSB
+// Switch debouncing: sample key switch (Timer 1, every 10ms), posts EV_KEY as soon as 8 identical samples in a row
+// differ from the debounced state
+void key_sample( void ) {
+    if ( !key_enabled ) {
+        return;
+    }
 
-        while ( !( TIFR0 & ( 1 << TOV0 ) ) ) // Wait for timer overflow
-            ;
+    key_history = ( key_history << 1 ) | ( ( KEY_PIN & ( 1 << KEY ) ) > 0 );
 
-        TIFR0 = ( 1 << TOV0 ); // Clear interrupt flag
-        TCNT0 = 160;           // Preload timer
+    if ( ( key_history == 0x00 ) && !key_closed ) {
+        key_closed = 1;
+        event_post( EV_KEY );
+    }
+    else if ( ( key_history == 0xFF ) && key_closed ) {
+        key_closed = 0;
+        event_post( EV_KEY );
+    }
+}
 
-        if ( ctr < 8 ) {
-            ctr++;             // Make sure at least 8 queries are executed
+// Debounced key state (1 for active switch, 0 for inactive). While interrupts are disabled (startup) the samples
+// are taken here, waiting for Timer 1, until the state is stable
+uint8_t key_armed( void ) {
+    if ( !( SREG & ( 1 << SREG_I ) ) ) {
+        while ( key_enabled && ( key_history != 0x00 ) && ( key_history != 0xFF ) ) {
+            while ( !clock_poll() )
+                ;
 
+            key_sample();
         }
     }
 
-    TCCR0B = timer0_regb;
-
-    // return 1 for active switch, 0 for inactive
-    return keystate == 0;
+    return key_closed;
 }
 
 // Create special symbols for LCD
@@ -174,12 +172,12 @@ uint8_t tempident( void ) {
     uint8_t checkup = 0;
 
     for ( uint8_t i = 5; i; i-- ) {
-        checkup += w1_reset();                         // In case of sensor connection w1_reset() will return 0
-        checkup += !( ( W1_PIN & ( 1 << W1 ) ) && 1 ); // In case of sensor connection the right side will end up as 0
+        checkup += ( w1_transfer( W1_RESET_ONLY, NULL, NULL, 0, 0 ) && 1 ); // In case of sensor connection the reset will return 0
+        checkup += !( ( W1_PIN & ( 1 << W1 ) ) && 1 );                       // In case of sensor connection the right side will end up as 0
     }
 
-    // Type of temp. sensor is detected by return value
-    if ( !checkup ) {
+    // Type of temp. sensor is detected by return value, the IDs of all sensors are kept for the readout
+    if ( !checkup && ( temp_sensors = w1_get_sensor_ids( temp_ids, TEMP_SENSORS ) ) ) {
         return DS18B20;
     }
     else {
@@ -189,37 +187,131 @@ uint8_t tempident( void ) {
     }
 }
 
-// Temperature measurement
-int8_t tempmeas( uint8_t type ) {
-    int16_t  temperature = -128;
-    uint16_t temp_hex;
-    uint32_t utimer;
+// Queue configuration (alarm limits, 9 bit resolution) and temperature conversion, both with SKIP_ROM so all sensors
+// convert at the same time. Returns 0 if there is no sensor or a measurement is still running
+uint8_t temp_start( uint8_t type ) {
+    if ( !type || temp_conf_req.busy || temp_conv_req.busy || temp_read_req.busy ) {
+        return 0;
+    }
+
+    temp_pad[0] = 125;
+    temp_pad[1] = (uint8_t) -40;
+    temp_pad[2] = TEMP_CONFIG_9BIT;
+    temp_index  = 0;
+
+    return w1_request( &temp_conf_req ) && w1_request( &temp_conv_req );
+}
+
+// ROM-ID to address sensor i with (a single sensor is read with SKIP_ROM)
+uint8_t *temp_id( uint8_t i ) {
+    return ( temp_sensors > 1 ) ? temp_ids[i] : NULL;
+}
+
+// Temperature from the scratchpad, -128 if it could not be read
+int8_t temp_result( uint8_t w1_result ) {
+    uint8_t crc = 0;
+
+    for ( uint8_t i = 0; i < 9; i++ ) {
+        crc = crc8( crc, temp_pad[i] );
+    }
 
-    if ( !type ) {
+    if ( w1_result || crc ) {
         return -128;
     }
-    else {
-        w1_temp_conf( 125, -40, 9 );
-        w1_command( CONVERT_T, NULL );
 
-        utimer = F_CPU / 128;
+    return (int8_t)w1_tempread_to_celsius( temp_pad[0] + ( temp_pad[1] << 8 ), 0 );
+}
+
+// Temperature measurement of all sensors, waits for the conversion (only used at startup and by the UART menu)
+void tempmeas( uint8_t type, int8_t temperature[TEMP_SENSORS] ) {
+    for ( uint8_t i = 0; i < TEMP_SENSORS; i++ ) {
+        temperature[i] = -128;
+    }
+
+    if ( !temp_start( type ) ) {
+        return;
+    }
+
+    w1_wait( &temp_conv_req );
+    _delay_ms( TEMP_CONV_TICKS * 10 );
+
+    for ( temp_index = 0; temp_index < temp_sensors; temp_index++ ) {
+        temperature[temp_index] = temp_result( w1_transfer( READ, temp_id( temp_index ), temp_pad, 0, 9 ) );
+    }
+}
+
+// Temperatures of all sensors (-128: n.a.) to the given position of a message
+void temp_to_frame( char *field, const int8_t temperature[TEMP_SENSORS] ) {
+    for ( uint8_t i = 0; i < TEMP_SENSORS; i++ ) {
+        field[i] = temperature[i];
+    }
+}
+
+// Deviation of at least band
+static uint8_t ident_differs( int16_t value, int16_t last, uint8_t band ) {
+    return ( value - last >= band ) || ( last - value >= band );
+}
+
+// Arm state, battery or temperature changed noticeably since the last report
+uint8_t ident_changed( const identstate_t *last, uint8_t armed, uint8_t battery, const int8_t temperature[TEMP_SENSORS] ) {
+    uint8_t changed = ( last->armed != armed ) || ident_differs( battery, last->battery, IDENT_BATTERY_BAND );
+
+    for ( uint8_t i = 0; i < TEMP_SENSORS; i++ ) {
+        if ( ident_differs( temperature[i], last->temperature[i], IDENT_TEMP_BAND ) ) {
+            changed = 1;
+        }
+    }
+
+    return changed;
+}
+
+// Remember reported parameters
+void ident_remember( identstate_t *last, uint8_t armed, uint8_t battery, const int8_t temperature[TEMP_SENSORS] ) {
+    last->armed   = armed;
+    last->battery = battery;
+
+    for ( uint8_t i = 0; i < TEMP_SENSORS; i++ ) {
+        last->temperature[i] = temperature[i];
+    }
+}
+
+// Decide whether to reply to IDENT and remember what gets sent: always for a full identification, for a refresh
+// only if this box hasn't replied within its epoch yet or arm state, battery or temperature changed
+uint8_t ident_reply( identstate_t *last, const char *field, uint8_t armed, uint8_t battery, const int8_t temperature[TEMP_SENSORS] ) {
+    if (  ( field[1] == IDENT_DELTA ) && last->valid && ( last->epoch == (uint8_t) field[2] )
+       && !ident_changed( last, armed, battery, temperature ) ) {
+        return 0;
+    }
+
+    last->epoch = field[2];
+    last->valid = 1;
+    ident_remember( last, armed, battery, temperature );
 
-        while ( --utimer && !w1_bit_io( 1 ) );
+    return 1;
+}
+
+// Pseudo random number for the backoff of status pushes (16 bit Galois LFSR, seeded with the unique-id)
+static uint16_t status_lfsr = 0xACE1;
 
-        w1_command( READ, NULL );
-        temp_hex    = w1_byte_rd();
-        temp_hex   += ( w1_byte_rd() ) << 8;
-        temperature = w1_tempread_to_celsius( temp_hex, 0 );
+void status_seed( uint8_t uid ) {
+    status_lfsr ^= ( uid << 8 ) | uid;
 
-        return (int8_t)temperature;
+    if ( !status_lfsr ) {
+        status_lfsr = 0xACE1;
     }
 }
 
+uint16_t status_random( void ) {
+    status_lfsr = ( status_lfsr >> 1 ) ^ ( -( status_lfsr & 1U ) & 0xB400U );
+
+    return status_lfsr;
+}
+
 // ------------------------------------------------------------------------------------------------------------------------
 
 // Check if received uart-data are a valid ignition command
 uint8_t fire_command_uart_valid( const char *field ) {
-    return ( field[0] == 0xFF ) && ( field[1] > 0 ) && ( field[1] < (MAX_ID+1) ) && ( field[2] > 0 ) && ( field[2] < 17 )
+    return ( field[0] == 0xFF ) && ( field[1] > 0 ) && ( field[1] < (MAX_ID+1) ) && ( field[2] > 0 ) && ( field[2] <= MAX_CHANNEL )
            && ( field[3] == crc8( crc8( 0, field[1] ), field[2] ) );
 }
 
@@ -233,7 +325,7 @@ void device_initialisation( uint8_t ignotrans ) {
         hist_del_flag     = 0;
         key_deinit();
         adc_deinit();
-        key_flag = 0;
+        event_cancel( EV_KEY );
         leds_off();
         lcd_init();
         create_symbols();
@@ -251,7 +343,7 @@ void device_initialisation( uint8_t ignotrans ) {
     else {
         sr_init();
         key_init();
-        key_flag = 1;
+        event_post( EV_KEY );
         adc_init();
         leds_off();
     }
@@ -287,20 +379,25 @@ int main( void ) {
     MOSSWITCHDDR  |= ( 1 << MOSSWITCH );
 
     // Local Variables
-    uint16_t scheme = 0, anti_scheme = 0, controlvar;
+    chanset_t scheme = 0, anti_scheme = 0;
     uint8_t  i, nr, inp, tmp;
     uint8_t  tx_length = 2, rx_length = 0;
     uint8_t  temp_sreg;
     uint8_t  slave_id = MAX_ID, unique_id = MAX_ID, rem_sid = MAX_ID, rem_uid = MAX_ID;
     uint8_t  rfm_rx_error = 1, rfm_tx_error = 0;
-    uint8_t  loopcount = 5, transmission_allowed = 1;
+    uint8_t  loopcount = 5, transmission_allowed = 1, tx_waiting = 0;
+    uint32_t tx_due    = 0;
     uint8_t  anzspalte = 1, anzzeile = 3, lastspalte = 15, lastzeile = 4;
     uint8_t  armed       = 0;
     uint8_t  changes     = 0;
     uint8_t  iderrors    = 0;
+    uint8_t  ident_epoch = 0;
     uint8_t  rssi        = 0;
-    uint8_t  ledscheme   = 0;
-    int8_t   temperature = -128;
+    uint8_t  event       = EVENT_NONE;
+    uint8_t  list_pos    = 0, list_sid = 0, imp_listpos = 0;
+    uint8_t  log_pos     = 0, log_next = 0, fire_local = 0;
+    uint32_t rx_time     = 0, fire_time = 0;
+    int8_t   temperature[TEMP_SENSORS];
 
     bitfeld_t flags;
     flags.complete = 0;
@@ -308,10 +405,11 @@ int main( void ) {
     char        uart_field[MAX_COM_ARRAYSIZE + 2] = { 0 };
     char        rx_field[MAX_COM_ARRAYSIZE + 1]   = { 0 };
     char        tx_field[MAX_COM_ARRAYSIZE + 1]   = { 0 };
-    char        quantity[MAX_ID + 1]              = { 0 };
-    fireslave_t slaves[MAX_ID + 1];
+    slavetable_t slaves                           = { .count = 0 };
+    identstate_t ident_last                       = { .valid = 0 };
+    imptable_t  imptable                         = { .count = 0 };
     char        lcd_array[MAX_COM_ARRAYSIZE + 1] = { 0 };
-    uint8_t     channel_timeout[16]              = { 0 };
+    uint8_t     channel_timeout[SR_CHANNELS]     = { 0 };
 
 
     /* For security reasons the shift registers are initialised right at the beginning to guarantee a low level at the
@@ -353,7 +451,13 @@ int main( void ) {
     adc_init();
     const uint8_t ig_or_notrans = ( adc_read( 5 ) < 156 );
 
-    // Get Slave- und Unique-ID from EEPROM for ignition devices
+    // Read settings from EEPROM (imports the former fixed addresses once)
+    settings_load();
+
+    // Find end of the event log
+    blackbox_init();
+
+    // Get Slave- und Unique-ID from the settings for ignition devices
     update_addresses( &unique_id, &slave_id );
 
     if ( ig_or_notrans ) {
@@ -367,6 +471,7 @@ int main( void ) {
             }
 
             addresses_save( unique_id, slave_id );
+            eeflush();
             wdt_enable( 6 );
 
             while ( 1 );
@@ -375,12 +480,16 @@ int main( void ) {
     else {
         if ( unique_id || slave_id ) {
             addresses_save( 0, 0 );
+            eeflush();
             wdt_enable( 6 );
 
             while ( 1 );
         }
     }
 
+    // Spread status pushes of the boxes
+    status_seed( unique_id );
+
     // Initialise arrays
     for ( uint8_t warten = 0; warten < MAX_COM_ARRAYSIZE; warten++ ) {
         uart_field[warten]             = 1;
@@ -388,14 +497,6 @@ int main( void ) {
         rx_field[warten]               = 0;
     }
 
-    for ( uint8_t warten = 0; warten < MAX_ID; warten++ ) {
-        slaves[warten].slave_id        = 0;
-        slaves[warten].battery_voltage = 0;
-        slaves[warten].sharpness       = 0;
-        slaves[warten].temperature     = -128;
-        slaves[warten].rssi            = 0;
-    }
-
     // Initialise devices
     device_initialisation( ig_or_notrans );
 
@@ -405,7 +506,7 @@ int main( void ) {
 
     // Detect temperature sensor and measure temperature if possible
     const uint8_t tempsenstype = tempident();
-    temperature = tempmeas( tempsenstype );
+    tempmeas( tempsenstype, temperature );
 
     // Initialise radio
     rfm_init();
@@ -413,13 +514,13 @@ int main( void ) {
     // Set encryption active, read and transfer AES-Key
     rfm_cmd( 0x3DA1, 1 );
     for ( uint8_t i = 0; i < 16; i++ ) {
-        rfm_cmd( ( 0x3E00 + i * ( 0x0100 ) ) | eeread( START_ADDRESS_AESKEY_STORAGE + i ), 1 );
+        rfm_cmd( ( 0x3E00 + i * ( 0x0100 ) ) | settings_get()->aeskey[i], 1 );
     }
 
     #if ( RFM == 69 )
-        uint8_t rfm_pwr = eeread( RFM_PWR_ADDRESS );
+        uint8_t rfm_pwr = settings_get()->rfm_pwr;
 
-        if ( ( eeread( RFM_PWR_ADDRESS + 1 ) == crc8( 0x11, rfm_pwr ) ) && ( rfm_pwr < 0x20 ) ) {
+        if ( rfm_pwr < 0x20 ) {
             rfm_cmd( ( 0x1180 | rfm_pwr ), 1 );
         }
 
@@ -427,8 +528,8 @@ int main( void ) {
 
     if ( TRANSMITTER ) {
         tx_field[0] = IDENT;
-        tx_field[1] = 'd';
-        tx_field[2] = '0';
+        tx_field[1] = IDENT_FULL;
+        tx_field[2] = ++ident_epoch;
 
         // Transmit something to make other devices adjust to frequency
         for ( uint8_t j = 5; j; j-- ) {
@@ -442,47 +543,10 @@ int main( void ) {
         TIMSK0 |= ( 1 << TOIE0 );
     }
     else {
-        // Display slave ID
-        leds_off();
-        _delay_ms(150);
-        led_yellow_on();
-        _delay_ms(150);
-        led_green_on();
-        _delay_ms(150);
-        led_orange_on();
-        _delay_ms(150);
-        led_red_on();
-        _delay_ms(150);
-        leds_off();
-        _delay_ms(250);
-        ledscheme = (slave_id & 0xF0) >> 4;
-        if( ledscheme & 0x01 ) led_yellow_on();
-        if( ledscheme & 0x02 ) led_green_on();
-        if( ledscheme & 0x04 ) led_orange_on();
-        if( ledscheme & 0x08 ) led_red_on();
-        _delay_ms(2000);
-        leds_off();
-        _delay_ms(150);
-        led_red_on();
-        _delay_ms(150);
-        led_orange_on();
-        _delay_ms(150);
-        led_green_on();
-        _delay_ms(150);
-        led_yellow_on();
-        _delay_ms(150);
-        leds_off();
-        _delay_ms(250);
-        ledscheme = (slave_id & 0x0F);
-        if( ledscheme & 0x01 ) led_yellow_on();
-        if( ledscheme & 0x02 ) led_green_on();
-        if( ledscheme & 0x04 ) led_orange_on();
-        if( ledscheme & 0x08 ) led_red_on();
-        _delay_ms(2000);
-        leds_off();
-        _delay_ms(200);
+        // Display slave ID (Timer 1 plays the pattern as soon as interrupts are enabled)
+        leds_show_id( slave_id );
 
-        armed = debounce( &KEY_PIN, KEY );
+        armed = key_armed();
 
         if ( armed ) {
             led_red_on();
@@ -491,15 +555,18 @@ int main( void ) {
             led_red_off();
         }
 
-        flags.b.clear_list = 1;
-        tx_field[0]        = PARAMETERS;
-        tx_field[1]        = unique_id;
-        tx_field[2]        = slave_id;
-        tx_field[3]        = adc_read( 5 );
-        tx_field[4]        = armed;
-        tx_field[5]        = temperature;
+        tx_field[0] = PARAMETERS;
+        tx_field[1] = unique_id;
+        tx_field[2] = slave_id;
+        tx_field[3] = adc_read( 5 );
+        tx_field[4] = armed;
+        temp_to_frame( &tx_field[5], temperature );
+
+        event_post( EV_CLEAR_LIST );
     }
 
+    blackbox_add( BLACKBOX_BOOT | armed, blackbox_time(), 0, 0 );
+
     flags.b.transmit = 1;
 
     // Enable Interrupts
@@ -508,860 +575,848 @@ int main( void ) {
     // Main loop
 
     /*
-     * Within the main loop the status of all the flags is continuously monitored and upon detection of a set flag
-     * the corresponding routine is executed. Before the execution of the routine the status register is written to a local
-     * variable, interrupts are disabled and the flag gets cleared, after the routine interrupts are re-enabled
+     * Within the main loop sources without interrupt (UART, radio, transmission slot) are polled first and turned
+     * into events and a few changed LCD cells are transferred, then the most urgent pending event is handled. Only one
+     * event is handled per pass, so firing and ending ignition pulses never wait for more than one chunk of
+     * housekeeping. Long jobs (lists) are split into several events, LCD output only changes the framebuffer. ISRs post
+     * events directly or schedule them for a later Timer 1 tick (event_post_in()), so delays need neither busy waiting
+     * nor counters of their own. Interrupts stay enabled, only data shared with ISRs is accessed with interrupts
+     * disabled, so an event waits at most for the handler running and the more urgent events pending.
+     *
+     * Without pending events the CPU sleeps until the next interrupt (see idle.h).
+     *
+     * Still blocking: the interactive UART menus (conf, remote, send, rfm, aeskey)
      *
      */
     while ( 1 ) {
         // -------------------------------------------------------------------------------------------------------
 
-        // Control key switch (key_flag gets set via pin-change-interrupt)
-        if ( key_flag ) {
-            temp_sreg = SREG;
-            cli();
-            key_flag = 0;
+        PROF_START( prof_poll );
+
+        // UART input pending?
+        if ( UCSR0A & ( 1 << RXC0 ) ) {
+            event_post( EV_UART );
+        }
 
-            // Box armed: armed = 1, Box not armed: armed = 0
-            armed = debounce( &KEY_PIN, KEY );
+        // Radio message pending?
+        if ( rfm_receiving() ) {
+            event_post( EV_RECEIVE );
+        }
 
-            if ( armed ) {
-                led_red_on();
-            }
-            else {
-                led_red_off();
+        // Check if device has waited long enough (according to unique-id) to be allowed to transmit
+        if ( !transmission_allowed && ( ( tx_waiting && clock_expired( tx_due ) ) || TRANSMITTER ) ) {
+            transmission_allowed = 1;
+            tx_waiting           = 0;
+        }
+
+        if ( flags.b.transmit && transmission_allowed ) {
+            // List has to be empty before asking for identification (a refresh keeps it)
+            if ( tx_field[0] == IDENT ) {
+                flags.b.ident_delta = ( tx_field[1] == IDENT_DELTA );
+                event_post( EV_CLEAR_LIST );
             }
 
-            SREG = temp_sreg;
+            event_post( EV_TRANSMIT );
         }
 
-        // -------------------------------------------------------------------------------------------------------
+        // Write the event log while no channel is firing (returns at once if the EEPROM queue is full)
+        if ( !flags.b.is_fire_active && !event_pending( EV_FIRE ) ) {
+            blackbox_flush();
+        }
 
-        // UART-Routine
-        flags.b.uart_active = ( ( UCSR0A & ( 1 << RXC0 ) ) && 1 );
+        PROF_STOP( PROF_POLL, prof_poll );
 
-        if ( flags.b.uart_active ) {
-            temp_sreg = SREG;
-            cli();
-            flags.b.uart_active = 0;
+        // Transfer some changed cells of the LCD framebuffer (returns at once if the display is still busy)
+        PROF_START( prof_lcd );
+        lcd_flush( LCD_FLUSH_CELLS );
+        PROF_STOP( PROF_LCD, prof_lcd );
 
-            led_yellow_on();
+        // -------------------------------------------------------------------------------------------------------
 
-            // Receive first char
-            uart_field[0] = uart_getc();
+        event = event_next();
+        PROF_START( prof_start );
 
-            // React according to first char (ignition command or not?)
-            // Ignition command is always 4 chars long
-            switch ( uart_field[0] ) {
-                case 0xFF: {
-                    uart_field[1] = uart_getc();
-                    uart_field[2] = uart_getc();
-                    uart_field[3] = uart_getc();
-                    uart_field[4] = '\0';
-                    break;
-                }
+        switch ( event ) {
+            // Fire
+            case EV_FIRE: {
+                if ( armed && ( rx_field[2] > 0 ) && ( rx_field[2] <= SR_CHANNELS ) ) { // If channel number is valid
+                    flags.b.is_fire_active = 1;                                           // Signalize that we're currently firing
 
-                // Any other command is received as long as it doesn't start with enter or backspace
-                case 8:
-                case 10:
-                case 13:
-                case 127: {
-                    uart_field[0] = '\0';
-                    break;
-                }
+                    // Turn all leds on (ends the slave-ID display)
+                    leds_cancel( LED_PRIO_ID );
+                    leds_on();
 
-                default: {
-                    #if !CASE_SENSITIVE
-                        uart_field[0] = uart_lower_case( uart_field[0] );
-                    #endif
-                    uart_putc( uart_field[0] ); // Show first char so everything looks as it should
+                    // Add the requested channel to the currently active ones
+                    scheme = chanset_bit( rx_field[2] - 1 ) | active_channels;
 
-                    if ( !uart_gets( uart_field + 1 ) ) {
-                        uart_puts_P( PSTR( "\033[1D" ) );
-                        uart_puts_P( PSTR( " " ) );
-                        uart_puts_P( PSTR( "\033[1D" ) );
-                        uart_field[0] = '\0';
-                    }
+                    MOSSWITCHPORT |= ( 1 << MOSSWITCH );
+                    sr_shiftout( scheme ); // Write pattern to shift-register
+                    active_channels = scheme;
 
-                    break;
+                    blackbox_add( BLACKBOX_FIRE | BLACKBOX_SWITCHED | fire_local, fire_time, rx_field[2], BLACKBOX_NA );
+                }
+                else {
+                    blackbox_add( BLACKBOX_FIRE | ( armed ? BLACKBOX_NO_CHANNEL : BLACKBOX_NOT_ARMED ) | fire_local, fire_time,
+                                  rx_field[2], BLACKBOX_NA );
                 }
-            }
 
-            // Evaluate inputs
-            // "conf" starts ID configuration
-            if ( uart_strings_equal( uart_field, "conf" ) ) {
-                flags.b.uart_config = 1;
-                flags.b.transmit    = 0;
-            }
+                // Turn on receiver
+                rfm_rxon();
 
-            // "remote" starts remote ID configuration
-            if ( uart_strings_equal( uart_field, "remote" ) ) {
-                flags.b.remote   = 1;
-                flags.b.transmit = 0;
+                break;
             }
 
-            // "clearlist" empties list of boxes
-            if ( uart_strings_equal( uart_field, "clearlist" ) ) {
-                flags.b.clear_list = 1;
-            }
+            // -------------------------------------------------------------------------------------------------------
 
-            // "send" allows to manually send a command
-            if (  uart_strings_equal( uart_field, "send" ) || uart_strings_equal( uart_field, "fire" )
-               || uart_strings_equal( uart_field, "ident" ) || uart_strings_equal( uart_field, "temp" ) ) {
-                flags.b.send     = 1;
-                flags.b.transmit = 0;
-            }
+            // Monitor active channels (posted every 10ms while firing) and stop firing if it's due
+            case EV_PULSE: {
+                uint8_t expired = 0;
 
-            // "list" gives a overview over connected boxes
-            if ( uart_strings_equal( uart_field, "list" ) ) {
-                flags.b.list     = 1;
-                flags.b.transmit = 0;
-            }
+                anti_scheme = 0;                                   // Reset the delete scheme
 
-            // "orders" shows last transmitted and received command on the LCD
-            if ( uart_strings_equal( uart_field, "orders" ) && TRANSMITTER ) {
-                flags.b.rx_post    = 1;
-                flags.b.tx_post    = 1;
-                flags.b.show_only  = 1;
-                flags.b.lcd_update = 1;
-            }
+                for ( uint8_t i = 0; i < SR_CHANNELS; i++ ) {
+                    if ( chanset_test( active_channels, i ) ) {      // If a given channel is currently active
+                        channel_timeout[i]++;                        // Increment the timeout-value for that channel
 
-            // "arm" arms transmitter
-            if ( uart_strings_equal( uart_field, "arm" ) && TRANSMITTER ) {
-                armed = 1;
-                led_red_on();
-            }
+                        if ( channel_timeout[i] >= IGNITION_TIME ) { // If the channel was active for at least the ignition time
+                            anti_scheme       |= chanset_bit( i );   // Set delete-bit for this channel
+                            channel_timeout[i] = 0;                  // Reset channel-timeout value
+                            expired            = 1;                  // Leave a note that a change in the list of active channels is due
+                        }
+                    }
+                }
 
-            // "disarm" disarms transmitter
-            if ( uart_strings_equal( uart_field, "disarm" ) && TRANSMITTER ) {
-                armed = 0;
-                led_red_off();
-            }
+                if ( !expired ) {
+                    break;
+                }
 
-            // "cls" clears terminal screen
-            if ( uart_strings_equal( uart_field, "cls" ) ) {
-                terminal_reset();
-            }
+                anti_scheme ^= active_channels; // Set channels to zero, which shell be deleted AND are active, others remain active.
 
-            // "kill" resets the controller
-            if ( uart_strings_equal( uart_field, "kill" ) ) {
-                flags.b.reset_device = 1;
-            }
+                // Lock respective MOSFETs
+                sr_shiftout( anti_scheme );     // Perform the necessary shift-register changes
 
-            // "hardware" or "hw" outputs for uC- and rfm-type
-            if ( uart_strings_equal( uart_field, "hw" ) || uart_strings_equal( uart_field, "hardware" ) ) {
-                flags.b.hw = 1;
-            }
+                active_channels = anti_scheme;  // Re-write the list of currently active channels
 
-            // "rfm" gives access to radio module
-            if ( uart_strings_equal( uart_field, "rfm" ) ) {
-                scheme = rfmtalk();
+                if ( !anti_scheme ) {                             // If no more channels are active at the moment
+                    MOSSWITCHPORT         &= ~( 1 << MOSSWITCH ); // Block the P-FET-channel
+                    flags.b.is_fire_active = 0;                   // Signalize that firing is finished for now
 
-                if ( scheme != 0xFFFF ) {
-                    #if ( RFM == 69 )
-                        rfm_pwr = 0;
+                    // Turn all LEDs off and the red one on again
+                    leds_off();
+                    led_red_on();
+                }
 
-                        if ( ( scheme & 0xFFE0 ) == 0x9180 ) {
-                            rfm_pwr = ( scheme & 0x001F );
-                        }
+                break;
+            }
 
-                        scheme = rfm_cmd( scheme, ( scheme & 32768 ) && 1 );
-                    #else
-                        scheme = rfm_cmd( scheme );
-                    #endif
-                    uart_puts_P( PSTR( " --> : 0x" ) );
-                    uart_shownum( scheme, 'h' );
+            // -------------------------------------------------------------------------------------------------------
 
-                    #if ( RFM == 69 )
+            // Received radio message
+            case EV_RECEIVE: {
+                rx_time = blackbox_time();                          // Time of receipt for the event log
+                leds_flash( LED_ORANGE, LED_FLASH_TICKS );
+                #ifdef RFM69_H_
+                    rssi = rfm_get_rssi_dbm();                      // Measure signal strength (RFM69 only)
+                #endif
+                rfm_rx_error = rfm_receive( rx_field, &rx_length ); // Get Message
+
+                if ( rfm_rx_error ) {
+                    rx_field[0] = ERROR;
+                }
+                else {
+                    switch ( rx_field[0] ) { // Act according to type of message received
+                        // Received ignition command (only relevant for ignition devices)
+                        case FIRE: {
+                            // Wait for all repetitions to be over
+                            waitRx( FIRE );
 
-                        if ( rfm_pwr ) {
-                            uart_puts_P( PSTR( "\r\nSendeleistung dauerhaft speichern (j/n)? " ) );
-                            inp = 0;
+                            // Receive continuously again if the box was in standby
+                            rfm_standby( 0 );
 
-                            while ( !( ( inp == 'j' ) || ( inp == 'n' ) ) ) inp = uart_getc() | 0x20;
+                            // No status pushes during a show
+                            temp_sreg      = SREG;
+                            cli();
+                            status_holdoff = STATUS_FIRE_HOLDOFF;
+                            SREG           = temp_sreg;
 
-                            uart_putc( inp );
-                            uart_puts_P( PSTR( "\r\n" ) );
+                            if ( ( rx_field[1] == slave_id ) && !TRANSMITTER ) {
+                                fire_time  = rx_time;
+                                fire_local = 0;
 
-                            if ( inp == 'j' ) {
-                                eewrite( rfm_pwr, RFM_PWR_ADDRESS );
-                                eewrite( crc8( 0x11, rfm_pwr ), ( RFM_PWR_ADDRESS + 1 ) );
-                                uart_puts_P( PSTR( "Speichern erfolgreich!\r\n" ) );
+                                event_post( EV_FIRE );  // Only gets logged if the box is not armed
                             }
+
+                            break;
                         }
 
-                    #endif
-                }
+                        // Received temperature-measurement-trigger
+                        case TEMPERATURE: {
+                            // Wait for all repetitions to be over
+                            waitRx( TEMPERATURE );
 
-                uart_puts( "\n\n\r" );
-            }
+                            // Start conversion, Timer 1 posts EV_TEMP when it is complete
+                            if ( temp_start( tempsenstype ) ) {
+                                event_post_in( EV_TEMP, TEMP_CONV_TICKS );
+                            }
 
-            // "aeskey" displays the current key and allows to set a new one
-            if ( uart_strings_equal( uart_field, "aeskey" ) ) {
-                changes = aesconf();
+                            break;
+                        }
 
-                if ( changes ) {
-                    flags.b.reset_device = 1;
-                }
+                        // Received identification-demand
+                        case IDENT: {
+                            // Wait for all repetitions to be over
+                            waitRx( IDENT );
 
-                changes = 0;
-            }
+                            flags.b.ident_delta = ( rx_field[1] == IDENT_DELTA );
+                            event_post( EV_CLEAR_LIST );
 
-            // If valid ignition command was received
-            if ( fire_command_uart_valid( uart_field ) ) {
-                // Transmit to everybody
-                tx_field[0]          = FIRE;
-                tx_field[1]          = uart_field[1];
-                tx_field[2]          = uart_field[2];
-                flags.b.transmit     = 1;
-                transmission_allowed = 1;
+                            tmp = ( TRANSMITTER ? 50 : adc_read( 5 ) );
 
-                // Check if ignition was triggered on device that received the serial command
-                if ( ( slave_id == uart_field[1] ) && !TRANSMITTER ) {
-                    tmp = uart_field[2] - 1;
+                            // Refresh: nothing new from this box
+                            if ( !ident_reply( &ident_last, rx_field, armed, tmp, temperature ) ) {
+                                break;
+                            }
 
-                    if ( !flags.b.fire ) {
-                        rx_field[2]  = uart_field[2];
-                        flags.b.fire = 1;
-                        loopcount    = 1;
-                    }
-                }
-            }
+                            tx_field[0] = PARAMETERS;
+                            tx_field[1] = unique_id;
+                            tx_field[2] = slave_id;
+                            tx_field[3] = tmp;
+                            tx_field[4] = armed;
+                            temp_to_frame( &tx_field[5], temperature );
 
-            led_yellow_off();
+                            transmission_allowed = 0;
 
-            if ( uart_field[0] && ( uart_field[0] != 0xFF ) ) {
-                uart_puts_P( PSTR( "\n\r" ) );
-            }
+                            tx_due               = clock_deadline( CLOCK_TICKS( unique_id * 10U + 10U ) );
+                            tx_waiting           = 1;
 
-            SREG = temp_sreg;
-        }
+                            flags.b.transmit = 1;
 
-        // -------------------------------------------------------------------------------------------------------
+                            break;
+                        }
 
-        // Hardware
-        if ( flags.b.hw ) {
-            temp_sreg = SREG;
-            cli();
-            flags.b.hw = 0;
-
-            uart_puts_P( PSTR( "\n\r" ) );
-            uart_puts( ig_or_notrans ? "Zündbox v1/v2" : "Transmitter" );
-            uart_puts_P( PSTR( "\n\r" ) );
-            uart_puts_P( PSTR( STRINGIZE_VALUE_OF( MCU ) ) );
-            uart_puts_P( PSTR( "\n\rRFM" ) );
-            uart_shownum( RFM, 'd' );
-            #if defined COMPILEDATE && defined COMPILETIME
-                uart_puts_P( PSTR( "\n\r" ) );
-                uart_puts_P( PSTR( "Datecode " ) );
-                uart_puts_P( PSTR( STRINGIZE_VALUE_OF( COMPILEDATE ) ) );
-                uart_puts_P( PSTR( STRINGIZE_VALUE_OF( COMPILETIME ) ) );
-            #endif
-            uart_puts_P( PSTR( "\n\n\r" ) );
+                        // Received Parameters (reply to IDENT) or status update (pushed by a box)
+                        case STATUS:
+                        case PARAMETERS: {
+                            // Wait for all repetitions to be over (STATUS has the same length)
+                            waitRx( PARAMETERS );
+
+                            // Increment ID error, if ID-error (='E') or 0 or unique-id of this device
+                            // or already used unique-id (except for a refresh or a status update) or an invalid slave-id was received
+                            if (   ( rx_field[1] == 'E' ) || ( !rx_field[1] ) || ( (uint8_t) rx_field[1] > MAX_ID )
+                               || ( rx_field[1] == unique_id ) || ( !flags.b.ident_delta && ( rx_field[0] == PARAMETERS ) && slaves_find( &slaves, rx_field[1] ) )
+                               || ( !rx_field[2] ) || ( (uint8_t) rx_field[2] > MAX_ID ) ) {
+                                iderrors++;
+                            }
+                            else {
+                                fireslave_t *box = slaves_put( &slaves, rx_field[1], rx_field[2] );
 
-            SREG = temp_sreg;
-        }
+                                if ( box ) {
+                                    box->battery_voltage = rx_field[3];
+                                    box->sharpness       = ( rx_field[4] ? 'j' : 'n' );
+                                    box->rssi            = rssi;
 
-        // -------------------------------------------------------------------------------------------------------
+                                    for ( uint8_t j = 0; j < TEMP_SENSORS; j++ ) {
+                                        box->temperature[j] = rx_field[5 + j];
+                                    }
+                                }
+                                // Report a full table right away (once per list), not only in "list"
+                                else if ( slaves.dropped == 1 ) {
+                                    uart_puts_P( PSTR( "\n\rSystemübersicht voll (max. " ) );
+                                    uart_shownum( SLAVES_MAX, 'd' );
+                                    uart_puts_P( PSTR( " Boxen), weitere Boxen werden nicht aufgenommen\n\r" ) );
+                                }
+                            }
 
-        // Slave- and Unique-ID settings
-        if ( flags.b.uart_config ) {
-            temp_sreg = SREG;
-            cli();
-            flags.b.uart_config = 0;
+                            break;
+                        }
 
-            changes = configprog( ig_or_notrans );
+                        // Received change command
+                        case CHANGE: {
+                            // Wait for all repetitions to be over
+                            waitRx( CHANGE );
+
+                            if ( !armed && ( unique_id == rx_field[1] ) && ( slave_id == rx_field[2] ) ) {
+                                rem_uid = rx_field[3];
+                                rem_sid = rx_field[4];
+
+                                // Change IDs if they are in the valid range (1-MAX_ID) and at least one of the two IDs is
+                                // a different value than before
+                                if (   ( ( rem_uid > 0 ) && ( rem_uid < (MAX_ID+1) ) ) && ( ( rem_sid > 0 ) && ( rem_sid < (MAX_ID+1) ) )
+                                   && ( ( rem_uid != unique_id ) || ( rem_sid != slave_id ) ) ) {
+                                    addresses_save( rem_uid, rem_sid );
+                                    event_post( EV_RESET );
+                                }
+                            }
 
-            if ( changes ) {
-                flags.b.reset_device = 1;
-            }
+                            break;
+                        }
 
-            changes = 0;
-            SREG    = temp_sreg;
-        }
+                        case MEASURE: {
+                            // Wait for all repetitions to be over
+                            waitRx( MEASURE );
 
-        // -------------------------------------------------------------------------------------------------------
+                            // Send empty impedance list because we cannot measure with version 1 and 2
+                            if ( unique_id == rx_field[1] ) {
+                                tx_field[0] = IMPEDANCES;
+                                tx_field[1] = unique_id;
 
-        // Remote Slave- and Unique-ID settings
-        if ( flags.b.remote ) {
-            temp_sreg = SREG;
-            cli();
-            flags.b.remote = 0;
+                                for ( uint8_t i = 0; i < IMPEDANCES_CHANNELS; i++ ) {
+                                    tx_field[2 + i] = 0x00;
+                                }
 
-            changes = 0;
-            changes = remote_config( tx_field );
+                                flags.b.transmit     = 1;
+                                transmission_allowed = 0;
+                                tx_due               = clock_deadline( CLOCK_TICKS( 10 ) ); // 100ms delay
+                                tx_waiting           = 1;
+                            }
 
-            if ( changes ) {
-                // If the numbers are those of the connected device
-                if ( ( tx_field[1] == unique_id ) && ( tx_field[2] == slave_id ) ) {
-                    uart_puts_P( PSTR( "\n\rIDs werden lokal angepasst!\n\r" ) );
-                    addresses_save( tx_field[3], tx_field[4] );
-                    flags.b.reset_device = 1;
-                }
-                // If not...
-                else {
-                    uart_puts_P( PSTR( "\n\rID-Konfigurationsbefehl wird gesendet!\n\r" ) );
-                    flags.b.transmit = 1;
-                }
+                            break;
+                        }
 
-                uart_puts_P( PSTR( "\n\n\r" ) );
-            }
+                        // Received compact impedance report (shown on the LCD of the transmitter)
+                        case IMPREPORT: {
+                            tmp = impreport_length( rx_field );
 
-            SREG = temp_sreg;
-        }
+                            if ( !tmp || ( tmp != rx_length ) ) {
+                                rx_field[0] = ERROR;
+                                break;
+                            }
 
-        // -------------------------------------------------------------------------------------------------------
+                            // Wait for all repetitions to be over
+                            waitRxLength( tmp );
 
-        // Manual transmission
-        if ( flags.b.send ) {
-            temp_sreg = SREG;
-            cli();
+                            // Report a full table right away (once per sweep), not only in "sweeplist"
+                            if ( !impreport_store( &imptable, rx_field ) && ( imptable.dropped == 1 ) ) {
+                                uart_puts_P( PSTR( "\n\rDurchgangstabelle voll (max. " ) );
+                                uart_shownum( IMPTABLE_MAX, 'd' );
+                                uart_puts_P( PSTR( " Boxen), weitere Antworten werden nicht aufgenommen\n\r" ) );
+                            }
 
-            flags.b.send = 0;
+                            break;
+                        }
 
-            nr = 0, tmp = 0, inp = 0;
+                        // Received request for the event log, sent in several messages
+                        case LOGREQUEST: {
+                            // Wait for all repetitions to be over
+                            waitRx( LOGREQUEST );
 
-            switch ( uart_field[0] ) {
-                case FIRE:
-                case IDENT:
-                case TEMPERATURE: {
-                    inp = uart_field[0];
-                    break;
-                }
+                            if ( ( unique_id == rx_field[1] ) && !TRANSMITTER ) {
+                                log_next = blackbox_to_frame( tx_field, unique_id, 0 );
 
-                default: {
-                    uart_puts_P( PSTR( "\n\rModus(f/i/t): " ) );
+                                if ( log_next ) {
+                                    transmission_allowed = 0;
+                                    tx_due               = clock_deadline( CLOCK_TICKS( BLACKBOX_GAP ) );
+                                    tx_waiting           = 1;
+                                    flags.b.transmit     = 1;
+                                }
+                            }
 
-                    while ( !inp ) inp = uart_getc() | 0x20;
+                            break;
+                        }
 
-                    uart_putc( inp );
-                    uart_puts_P( PSTR( "\r\n" ) );
-                    break;
-                }
-            }
+                        // Received part of the event log of a box
+                        case LOGDATA: {
+                            // Wait for all repetitions to be over
+                            waitRx( LOGDATA );
 
-            tx_field[0] = inp;
+                            for ( uint8_t j = 0; j < BLACKBOX_PER_MESSAGE; j++ ) {
+                                blackbox_entry_t *entry = (blackbox_entry_t *) &rx_field[BLACKBOX_MESSAGE + j * BLACKBOX_ENTRY_SIZE];
 
-            if ( ( tx_field[0] == FIRE ) || ( tx_field[0] == IDENT ) || ( tx_field[0] == TEMPERATURE ) ) {
-                // Assume, that a transmission shall take place
-                tmp = 1;
+                                if ( blackbox_valid( entry ) ) {
+                                    list_blackbox( rx_field[1], entry );
+                                }
+                            }
 
-                // Handle slave-id and channel input
-                switch ( tx_field[0] ) {
-                    case FIRE: {
-                        for ( uint8_t round = 1; round < 3; round++ ) {                                  // Loop twice
-                            nr = 0;
-                            uart_puts_P( round < 2 ? PSTR( "Slave-ID:\t" ) : PSTR( "\n\rKanal:  \t" ) ); // First for slave-id, then for channel
+                            break;
+                        }
 
-                            for ( i = 0; i < 2; i++ ) {                                 // Get the user to assign the numbers with 2 digits
-                                inp = 0;
+                        // Received request for the RAM usage (soak tests)
+                        case MEMREQUEST: {
+                            // Wait for all repetitions to be over
+                            waitRx( MEMREQUEST );
 
-                                while ( !inp ) inp = uart_getc();
+                            if ( ( unique_id == rx_field[1] ) && !TRANSMITTER ) {
+                                memstat_to_frame( tx_field, unique_id );
 
-                                uart_putc( inp );
-                                nr *= 10;
-                                nr += ( inp - '0' );
+                                transmission_allowed = 0;
+                                tx_due               = clock_deadline( CLOCK_TICKS( MEMSTAT_DELAY ) );
+                                tx_waiting           = 1;
+                                flags.b.transmit     = 1;
                             }
 
-                            uart_puts_P( PSTR( " = " ) );
+                            break;
+                        }
 
-                            if ( ( nr > 0 ) && ( nr < ( ( round < 2 ) ? (MAX_ID+1) : 17 ) ) ) { // Slave-ID has to be 1-MAX_ID, Channel 1-16
-                                uart_shownum( nr, 'd' );
-                                tx_field[round] = nr;
-                            }
-                            else {                                                      // Otherwise the input's invalid
-                                uart_puts_P( PSTR( "Ungültige Eingabe" ) );
-                                tmp   = 0;                                              // Sending gets disallowed
-                                round = 3;
+                        // Standby: receive in Listen Mode until WAKEUP, FIRE or arming (applied by rfm_rxon() below),
+                        // further repetitions are just handled again. Armed boxes stay on continuous reception.
+                        case STANDBY: {
+                            if ( !TRANSMITTER && !armed ) {
+                                rfm_standby( 1 );
                             }
-                        }
 
-                        break;
-                    }
+                            break;
+                        }
 
-                    case IDENT: {
-                        tx_field[0] = IDENT;
-                        tx_field[1] = 'd';
-                        tx_field[2] = '0';
-                        break;
-                    }
+                        // End of standby, receive continuously again (one of many repetitions)
+                        case WAKEUP: {
+                            rfm_standby( 0 );
+                            break;
+                        }
 
-                    case TEMPERATURE: {
-                        temperature = tempmeas( tempsenstype );
+                        // Received RAM usage of a box
+                        case MEMREPORT: {
+                            memstat_t stat;
 
-                        uart_puts_P( PSTR( "Temperatur: " ) );
+                            // Wait for all repetitions to be over
+                            waitRx( MEMREPORT );
 
-                        if ( temperature == -128 ) {
-                            uart_puts_P( PSTR( "n.a." ) );
-                        }
-                        else {
-                            fixedspace( temperature, 'd', 4 );
-                            uart_puts_P( PSTR( "°C" ) );
+                            memstat_from_frame( rx_field, &stat );
+                            list_memstat( rx_field[1], &stat );
+                            break;
                         }
 
-                        // Request other devices to refresh temperature as well
-                        tx_field[0] = TEMPERATURE;
-                        tx_field[1] = 'e';
-                        tx_field[2] = 'm';
-                        tx_field[3] = 'p';
-                        break;
+                        // Default action (do nothing)
+                        default: {
+                            break;
+                        }
                     }
 
-                    default: {
-                        break;
+                    if ( TRANSMITTER ) {
+                        event_post( EV_LCD_RX );
                     }
                 }
+
+                rfm_rxon();
+
+                break;
             }
 
-            uart_puts_P( PSTR( "\n\n\r" ) );
+            // -------------------------------------------------------------------------------------------------------
 
-            // Take action after proper command
-            if ( tmp ) {
-                flags.b.transmit     = 1;
-                transmission_allowed = 1;
+            // Clear list of ignition devices (a refresh keeps the entries of boxes that don't reply)
+            case EV_CLEAR_LIST: {
+                if ( !flags.b.ident_delta ) {
+                    iderrors = 0;
+                    slaves_clear( &slaves );
+                }
 
-                if ( ( tx_field[0] == FIRE ) && ( slave_id == tx_field[1] ) ) {
-                    rx_field[2]  = tx_field[2];
-                    flags.b.fire = 1;
+                // Ignition devices have to write themselves in the list
+                if ( !TRANSMITTER ) {
+                    fireslave_t *box = slaves_put( &slaves, unique_id, slave_id );
+
+                    if ( box ) {
+                        box->battery_voltage = adc_read( 5 );
+                        box->sharpness       = ( armed ? 'j' : 'n' );
+                        box->rssi            = 0;
+
+                        for ( i = 0; i < TEMP_SENSORS; i++ ) {
+                            box->temperature[i] = temperature[i];
+                        }
+                    }
                 }
-            }
-            else {
-                flags.b.transmit = 0;
+
+                break;
             }
 
-            while ( UCSR0A & ( 1 << RXC0 ) ) inp = UDR0;
+            // -------------------------------------------------------------------------------------------------------
 
-            SREG = temp_sreg;
-        }
+            // Transmission process
+            case EV_TRANSMIT: {
+                // Some other event might have withdrawn the transmission in the meantime
+                if ( !( flags.b.transmit && transmission_allowed ) ) {
+                    break;
+                }
 
-        // -------------------------------------------------------------------------------------------------------
+                flags.b.transmit = 0;
 
-        // List network devices
-        if ( flags.b.list ) {
-            temp_sreg = SREG;
-            cli();
+                switch ( tx_field[0] ) {
+                    setTxCase( FIRE );
+                    setTxCase( CHANGE );
+                    setTxCase( IDENT );
+                    setTxCase( TEMPERATURE );
+                    setTxCase( PARAMETERS );
+                    setTxCase( MEASURE );
+                    setTxCase( IMPEDANCES );
+                    setTxCase( LOGREQUEST );
+                    setTxCase( LOGDATA );
+                    setTxCase( MEMREQUEST );
+                    setTxCase( MEMREPORT );
+                    setTxCase( STATUS );
+                    setTxCase( STANDBY );
+                    setTxCase( WAKEUP );
 
-            flags.b.list = 0;
+                    default: {
+                        loopcount = 0;
+                        tmp       = 0;
+                        break;
+                    }
+                }
 
-            list_complete( slaves, iderrors );
-            evaluate_boxes( slaves, quantity );
-            list_array( quantity );
+                tx_field[tmp]     = loopcount;
+                tx_field[tmp + 1] = '\0';
+                tx_length         = tmp + 1;
 
-            SREG = temp_sreg;
-        }
+                if ( ( tx_field[0] != FIRE ) || armed ) { // Only send 'FIRE' if sending device is armed
+                    for ( uint8_t i = loopcount; i; i-- ) {
+                        led_green_on();
 
-        // -------------------------------------------------------------------------------------------------------
+                        rfm_tx_error = rfm_transmit( tx_field, tx_length ); // Transmit message
+                        tx_field[tmp]--;
 
-        // Software-Reset via Watchdog
-        if ( flags.b.reset_device ) {
-            cli();
+                        led_green_off();
+                    }
 
-            if ( TRANSMITTER ) {
-                lcd_clear();
-                lcd_puts( "Resetting device!" );
-            }
-            else {
-                sr_disable();
-            }
-
-            wdt_enable( 6 );
-            terminal_reset();
-
-            while ( 1 );
-        }
-
-        // -------------------------------------------------------------------------------------------------------
+                    if ( TRANSMITTER ) {
+                        event_post( EV_LCD_TX );
+                    }
+                }
 
-        // Clear list of ignition devices
-        if ( flags.b.clear_list || ( flags.b.transmit && ( tx_field[0] == IDENT ) ) ) {
-            temp_sreg = SREG;
-            cli();
+                tx_waiting           = 0;
+                transmission_allowed = 0;
 
-            flags.b.clear_list = 0;
+                // Event log: next message after a short break
+                if ( ( tx_field[0] == LOGDATA ) && ( log_next < BLACKBOX_ENTRIES ) ) {
+                    log_next = blackbox_to_frame( tx_field, unique_id, log_next );
 
-            iderrors = 0;
+                    if ( log_next ) {
+                        transmission_allowed = 0;
+                        tx_due               = clock_deadline( CLOCK_TICKS( BLACKBOX_GAP ) );
+                        tx_waiting           = 1;
+                        flags.b.transmit     = 1;
+                    }
+                }
 
-            for ( i = 0; i < MAX_ID; i++ ) {
-                quantity[i]               = 0;
-                slaves[i].slave_id        = 0;
-                slaves[i].battery_voltage = 0;
-                slaves[i].sharpness       = 0;
-                slaves[i].temperature     = -128;
-                slaves[i].rssi            = -128;
-            }
+                rfm_rxon();
 
-            // Ignition devices have to write themselves in the list
-            if ( !TRANSMITTER ) {
-                quantity[slave_id - 1]                = 1;
-                slaves[unique_id - 1].slave_id        = slave_id;
-                slaves[unique_id - 1].battery_voltage = adc_read( 5 );
-                slaves[unique_id - 1].sharpness       = ( armed ? 'j' : 'n' );
-                slaves[unique_id - 1].temperature     = temperature;
-                slaves[unique_id - 1].rssi            = 0;
+                break;
             }
 
-            SREG = temp_sreg;
-        }
+            // -------------------------------------------------------------------------------------------------------
 
-        // -------------------------------------------------------------------------------------------------------
+            // Software-Reset via Watchdog
+            case EV_RESET: {
+                cli();
 
-        // Transmit
-        // Check if device has waited long enough (according to unique-id) to be allowed to transmit
-        if ( !transmission_allowed && ( ( ( timer1_flags & TIMER_TRANSMITCOUNTER_FLAG ) && ( transmit_flag > ( unique_id * 10U + 10U ) ) ) || TRANSMITTER ) ) {
-            transmission_allowed = 1;
-        }
-
-        // Transmission process
-        if ( flags.b.transmit && transmission_allowed ) {
-            temp_sreg = SREG;
-            cli();
-
-            flags.b.transmit = 0;
-
-            switch ( tx_field[0] ) {
-                setTxCase( FIRE );
-                setTxCase( CHANGE );
-                setTxCase( IDENT );
-                setTxCase( TEMPERATURE );
-                setTxCase( PARAMETERS );
-                setTxCase( MEASURE );
-                setTxCase( IMPEDANCES );
-
-                default: {
-                    loopcount = 0;
-                    tmp       = 0;
-                    break;
+                if ( TRANSMITTER ) {
+                    lcd_clear();
+                    lcd_puts( "Resetting device!" );
+                    lcd_flush_all();
                 }
-            }
-
-            tx_field[tmp]     = loopcount;
-            tx_field[tmp + 1] = '\0';
-            tx_length         = tmp + 1;
-
-            if ( ( tx_field[0] != FIRE ) || armed ) { // Only send 'FIRE' if sending device is armed
-                for ( uint8_t i = loopcount; i; i-- ) {
-                    led_green_on();
-
-                    rfm_tx_error = rfm_transmit( tx_field, tx_length ); // Transmit message
-                    tx_field[tmp]--;
-
-                    led_green_off();
+                else {
+                    sr_disable();
                 }
 
-                flags.b.lcd_update = 1;
-                flags.b.tx_post    = 1;
-            }
-
-            timer1_flags        &= ~TIMER_TRANSMITCOUNTER_FLAG;
-            transmit_flag        = 0;
-            transmission_allowed = 0;
-
-            rfm_rxon();
-
-            SREG = temp_sreg;
-        }
-
-        // -------------------------------------------------------------------------------------------------------
-
-        // Fire
-        if ( flags.b.fire ) {
-            temp_sreg = SREG;
-            cli();
-            flags.b.fire = 0;
-
-            if ( armed && ( rx_field[2] > 0 ) && ( rx_field[2] < 17 ) ) { // If channel number is valid
-                tmp = rx_field[2];                                        // Save channel number to variable
-
-                flags.b.is_fire_active = 1;                               // Signalize that we're currently firing
-
-                // Turn all leds on
-                leds_on();
+                eeflush();                      // Queued EEPROM writes have to be finished before the reset
+                wdt_enable( 6 );
+                terminal_reset();
 
-                scheme = 0;                                               // Set mask-variable to zero
+                while ( 1 );
+            }
 
-                for ( uint8_t i = 16; i; i-- ) {
-                    scheme <<= 1;    // Left-shift mask-variable
+            // -------------------------------------------------------------------------------------------------------
 
-                    if ( i == tmp ) {
-                        scheme |= 1; // Set LSB if loop variable equals channel number
+            // Control key switch (EV_KEY gets posted by Timer 1 when the debounced state changes)
+            case EV_KEY: {
+                // Box armed: armed = 1, Box not armed: armed = 0
+                if ( key_armed() != armed ) {
+                    armed = !armed;
+                    blackbox_add( armed ? BLACKBOX_ARM : BLACKBOX_DISARM, blackbox_time(), 0, 0 );
+                    event_post( EV_STATUS );
 
+                    // Arming ends the standby of the receiver
+                    if ( armed && rfm_standby_active() ) {
+                        rfm_standby( 0 );
+                        rfm_rxon();
                     }
                 }
 
-                scheme |= active_channels;
+                if ( armed ) {
+                    led_red_on();
+                }
+                else {
+                    led_red_off();
+                }
 
-                MOSSWITCHPORT |= ( 1 << MOSSWITCH );
-                sr_shiftout( scheme ); // Write pattern to shift-register
-                active_channels = scheme;
+                break;
             }
 
-            // Turn on receiver
-            rfm_rxon();
+            // -------------------------------------------------------------------------------------------------------
 
-            SREG = temp_sreg;
-        }
+            // UART-Routine
+            case EV_UART: {
+                led_yellow_on();
 
-        // -------------------------------------------------------------------------------------------------------
+                // Receive first char
+                uart_field[0] = uart_getc();
 
-        if ( flags.b.is_fire_active && channel_monitor ) { // If we're currently firing and monitoring is due
-            temp_sreg = SREG;
-            cli();
+                // React according to first char (ignition command or not?)
+                // Ignition command is always 4 chars long
+                switch ( uart_field[0] ) {
+                    case 0xFF: {
+                        uart_field[1] = uart_getc();
+                        uart_field[2] = uart_getc();
+                        uart_field[3] = uart_getc();
+                        uart_field[4] = '\0';
+                        break;
+                    }
 
-            channel_monitor = 0;                           // Clear the monitoring flag
-            anti_scheme     = 0;                           // Reset the delete scheme
+                    // Any other command is received as long as it doesn't start with enter or backspace
+                    case 8:
+                    case 10:
+                    case 13:
+                    case 127: {
+                        uart_field[0] = '\0';
+                        break;
+                    }
 
-            controlvar = 1;
-            for ( uint8_t i = 0; i < 16; i++ ) {
-                if ( active_channels & controlvar ) { // If a given channel is currently active
-                    channel_timeout[i]++;             // Increment the timeout-value for that channel
+                    default: {
+                        #if !CASE_SENSITIVE
+                            uart_field[0] = uart_lower_case( uart_field[0] );
+                        #endif
+                        uart_putc( uart_field[0] ); // Show first char so everything looks as it should
+
+                        if ( !uart_gets( uart_field + 1 ) ) {
+                            uart_puts_P( PSTR( "\033[1D" ) );
+                            uart_puts_P( PSTR( " " ) );
+                            uart_puts_P( PSTR( "\033[1D" ) );
+                            uart_field[0] = '\0';
+                        }
 
-                    if ( channel_timeout[i] >= IGNITION_TIME ) { // If the channel was active for at least the ignition time
-                        anti_scheme          |= controlvar;      // Set delete-bit for this channel
-                        channel_timeout[i]    = 0;               // Reset channel-timeout value
-                        flags.b.finish_firing = 1;               // Leave a note that a change in the list of active channels is due
+                        break;
                     }
                 }
 
-                controlvar <<= 1; // Left-shift mask-variable
-            }
-            anti_scheme ^= active_channels; // Set channels to zero, which shell be deleted AND are active, others remain active.
-            SREG         = temp_sreg;
-        }
-
-        // -------------------------------------------------------------------------------------------------------
-
-        // Stop firing if it's due
-        if ( flags.b.finish_firing ) {      // If we have the order to stop firing on at least one channel
-            temp_sreg = SREG;
-            cli();
-            flags.b.finish_firing = 0;      // Mark the order as done
-
-            // Lock respective MOSFETs
-            sr_shiftout( anti_scheme );     // Perform the necessary shift-register changes
+                // Evaluate inputs
+                // "conf" starts ID configuration
+                if ( uart_strings_equal( uart_field, "conf" ) ) {
+                    flags.b.transmit = 0;
+                    event_post( EV_CONFIG );
+                }
 
-            active_channels = anti_scheme;  // Re-write the list of currently active channels
+                // "remote" starts remote ID configuration
+                if ( uart_strings_equal( uart_field, "remote" ) ) {
+                    flags.b.transmit = 0;
+                    event_post( EV_REMOTE );
+                }
 
-            if ( !anti_scheme ) {                             // If no more channels are active at the moment
-                MOSSWITCHPORT         &= ~( 1 << MOSSWITCH ); // Block the P-FET-channel
-                flags.b.is_fire_active = 0;                   // Signalize that firing is finished for now
+                // "clearlist" empties list of boxes
+                if ( uart_strings_equal( uart_field, "clearlist" ) ) {
+                    event_post( EV_CLEAR_LIST );
+                }
 
-                // Turn all LEDs off and the red one on again
-                leds_off();
-                led_red_on();
-            }
+                // "send" allows to manually send a command
+                if (  uart_strings_equal( uart_field, "send" ) || uart_strings_equal( uart_field, "fire" )
+                   || uart_strings_equal( uart_field, "ident" ) || uart_strings_equal( uart_field, "temp" )
+                   || uart_strings_equal( uart_field, "measure" ) || uart_strings_equal( uart_field, "refresh" )
+                   || uart_strings_equal( uart_field, "wakeup" ) ) {
+                    flags.b.transmit = 0;
+                    event_post( EV_SEND );
+                }
 
-            SREG = temp_sreg;
-        }
+                // "standby" puts the receivers of the boxes into Listen Mode (same as "send" with mode b)
+                if ( uart_strings_equal( uart_field, "standby" ) ) {
+                    uart_field[0]    = STANDBY;
+                    flags.b.transmit = 0;
+                    event_post( EV_SEND );
+                }
 
-        // -------------------------------------------------------------------------------------------------------
+                // "list" gives a overview over connected boxes
+                if ( uart_strings_equal( uart_field, "list" ) ) {
+                    flags.b.transmit = 0;
+                    list_pos         = 0;
+                    list_sid         = 0;
+                    slaves_sort( &slaves );
+                    event_post( EV_LIST );
+                }
 
-        // Check receive flag
-        temp_sreg = SREG;
-        cli();
-        flags.b.receive = rfm_receiving();
-        SREG            = temp_sreg;
+                // "sweep" asks all boxes for their continuity, replies are collected in the table
+                if ( uart_strings_equal( uart_field, "sweep" ) ) {
+                    impreport_restart( &imptable );
 
-        // Receive
-        if ( flags.b.receive ) {
-            temp_sreg = SREG;
-            cli();
+                    tx_field[0]          = MEASURE;
+                    tx_field[1]          = 0;
+                    tx_field[2]          = IMPREPORT;
+                    flags.b.transmit     = 1;
+                    transmission_allowed = 1;
 
-            flags.b.receive = 0;
+                    uart_puts_P( PSTR( "\n\rDurchgangsprüfung gestartet, Ergebnis nach ca. " ) );
+                    uart_shownum( ( IMPREPORT_SWEEP_OFFSET + ( MAX_ID + 1 ) * IMPREPORT_SWEEP_SLOT + 99 ) / 100, 'd' );
+                    uart_puts_P( PSTR( "s mit \"sweeplist\"\n\n\r" ) );
+                }
 
-            led_orange_on();
-            #ifdef RFM69_H_
-                rssi = rfm_get_rssi_dbm();                      // Measure signal strength (RFM69 only)
-            #endif
-            rfm_rx_error = rfm_receive( rx_field, &rx_length ); // Get Message
-            led_orange_off();
+                // "sweeplist" shows the continuity table
+                if ( uart_strings_equal( uart_field, "sweeplist" ) ) {
+                    flags.b.transmit = 0;
+                    imp_listpos      = 0;
+                    event_post( EV_LIST_IMP );
+                }
 
-            if ( rfm_rx_error ) {
-                rx_field[0] = ERROR;
-            }
-            else {
-                switch ( rx_field[0] ) { // Act according to type of message received
-                    // Received ignition command (only relevant for ignition devices)
-                    case FIRE: {
-                        // Wait for all repetitions to be over
-                        waitRx( FIRE );
+                // "orders" shows last transmitted and received command on the LCD
+                if ( uart_strings_equal( uart_field, "orders" ) && TRANSMITTER ) {
+                    flags.b.show_only = 1;
+                    event_post( EV_LCD_TX );
+                    event_post( EV_LCD_RX );
+                }
 
-                        if ( armed && ( rx_field[1] == slave_id ) && !TRANSMITTER ) {
-                            tmp = rx_field[2] - 1;
+                // "arm" arms transmitter
+                if ( uart_strings_equal( uart_field, "arm" ) && TRANSMITTER ) {
+                    if ( !armed ) {
+                        blackbox_add( BLACKBOX_ARM, blackbox_time(), 0, 0 );
+                    }
 
-                            if ( !flags.b.fire ) {
-                                flags.b.fire = 1;
-                            }
-                        }
+                    armed = 1;
+                    led_red_on();
+                }
 
-                        break;
+                // "disarm" disarms transmitter
+                if ( uart_strings_equal( uart_field, "disarm" ) && TRANSMITTER ) {
+                    if ( armed ) {
+                        blackbox_add( BLACKBOX_DISARM, blackbox_time(), 0, 0 );
                     }
 
-                    // Received temperature-measurement-trigger
-                    case TEMPERATURE: {
-                        // Wait for all repetitions to be over
-                        waitRx( TEMPERATURE );
+                    armed = 0;
+                    led_red_off();
+                }
 
-                        temperature = tempmeas( tempsenstype );
-                        break;
-                    }
+                // "cls" clears terminal screen
+                if ( uart_strings_equal( uart_field, "cls" ) ) {
+                    terminal_reset();
+                }
 
-                    // Received identification-demand
-                    case IDENT: {
-                        // Wait for all repetitions to be over
-                        waitRx( IDENT );
+                // "log" lists the event log of this device
+                if ( uart_strings_equal( uart_field, "log" ) ) {
+                    log_pos = 0;
+                    event_post( EV_LOG );
+                }
 
-                        tx_field[0] = PARAMETERS;
-                        tx_field[1] = unique_id;
-                        tx_field[2] = slave_id;
-                        tx_field[3] = ( TRANSMITTER ? 50 : adc_read( 5 ) );
-                        tx_field[4] = armed;
-                        tx_field[5] = temperature;
+                // "mem" shows the RAM usage of this device
+                if ( uart_strings_equal( uart_field, "mem" ) ) {
+                    memstat_t stat;
 
-                        transmission_allowed = 0;
+                    memstat_read( &stat );
+                    uart_puts_P( PSTR( "\n\n\rSpeicher\n\r" ) );
+                    uart_puts_P( PSTR( "========\n\r" ) );
+                    list_memstat( unique_id, &stat );
+                    uart_puts_P( PSTR( "\n\r" ) );
+                }
 
-                        timer1_reset();
-                        timer1_flags |= TIMER_TRANSMITCOUNTER_FLAG;
-                        transmit_flag = 0;
+                // "prof" shows and resets the runtimes of the main-loop sections (profiling build only)
+                if ( uart_strings_equal( uart_field, "prof" ) ) {
+                    uart_puts_P( PSTR( "\n\n\rLaufzeiten\n\r" ) );
+                    uart_puts_P( PSTR( "==========\n\r" ) );
+                    #if PROFILING
+                        list_prof();
+                        prof_reset();
+                    #else
+                        uart_puts_P( PSTR( "Nur im Profiling-Build (PROFILING=1)\n\r" ) );
+                    #endif
+                    uart_puts_P( PSTR( "\n\r" ) );
+                }
 
-                        flags.b.transmit   = 1;
-                        flags.b.clear_list = 1;
+                // "kill" resets the controller
+                if ( uart_strings_equal( uart_field, "kill" ) ) {
+                    event_post( EV_RESET );
+                }
 
-                        break;
-                    }
+                // "hardware" or "hw" outputs for uC- and rfm-type
+                if ( uart_strings_equal( uart_field, "hw" ) || uart_strings_equal( uart_field, "hardware" ) ) {
+                    event_post( EV_HW );
+                }
 
-                    // Received Parameters
-                    case PARAMETERS: {
-                        // Wait for all repetitions to be over
-                        waitRx( PARAMETERS );
-
-                        // Increment ID error, if ID-error (='E') or 0 or unique-id of this device
-                        // or already used unique-id was received as unique-id
-                        if (   ( rx_field[1] == 'E' ) || ( !rx_field[1] ) || ( rx_field[1] == unique_id )
-                           || ( rx_field[1] && slaves[(uint8_t)( rx_field[1] - 1 )].slave_id ) ) {
-                            iderrors++;
-                        }
-                        else {
-                            tmp                         = rx_field[1] - 1; // Index = unique_id-1 (zero-based indexing)
-                            slaves[tmp].slave_id        = rx_field[2];
-                            slaves[tmp].battery_voltage = rx_field[3];
-                            slaves[tmp].sharpness       = ( rx_field[4] ? 'j' : 'n' );
-                            slaves[tmp].temperature     = rx_field[5];
-                            slaves[tmp].rssi            = rssi;
-                        }
+                // "rfm" gives access to radio module
+                if ( uart_strings_equal( uart_field, "rfm" ) ) {
+                    uint16_t rfm_order = rfmtalk();
 
-                        break;
-                    }
+                    if ( rfm_order != 0xFFFF ) {
+                        #if ( RFM == 69 )
+                            rfm_pwr = 0;
 
-                    // Received change command
-                    case CHANGE: {
-                        // Wait for all repetitions to be over
-                        waitRx( CHANGE );
-
-                        if ( !armed && ( unique_id == rx_field[1] ) && ( slave_id == rx_field[2] ) ) {
-                            rem_uid = rx_field[3];
-                            rem_sid = rx_field[4];
-
-                            // Change IDs if they are in the valid range (1-MAX_ID) and at least one of the two IDs is
-                            // a different value than before
-                            if (   ( ( rem_uid > 0 ) && ( rem_uid < (MAX_ID+1) ) ) && ( ( rem_sid > 0 ) && ( rem_sid < (MAX_ID+1) ) )
-                               && ( ( rem_uid != unique_id ) || ( rem_sid != slave_id ) ) ) {
-                                addresses_save( rem_uid, rem_sid );
-                                flags.b.reset_device = 1;
+                            if ( ( rfm_order & 0xFFE0 ) == 0x9180 ) {
+                                rfm_pwr = ( rfm_order & 0x001F );
                             }
-                        }
 
-                        break;
-                    }
+                            rfm_order = rfm_cmd( rfm_order, ( rfm_order & 32768 ) && 1 );
+                        #else
+                            rfm_order = rfm_cmd( rfm_order );
+                        #endif
+                        uart_puts_P( PSTR( " --> : 0x" ) );
+                        uart_shownum( rfm_order, 'h' );
 
-                    case MEASURE: {
-                        // Wait for all repetitions to be over
-                        waitRx( MEASURE );
+                        #if ( RFM == 69 )
 
-                        // Send empty impedance list because we cannot measure with version 1 and 2
-                        if ( unique_id == rx_field[1] ) {
-                            tx_field[0] = IMPEDANCES;
-                            tx_field[1] = unique_id;
+                            if ( rfm_pwr ) {
+                                uart_puts_P( PSTR( "\r\nSendeleistung dauerhaft speichern (j/n)? " ) );
+                                inp = 0;
 
-                            for ( uint8_t i = 0; i < 16; i++ ) {
-                                tx_field[2 + i] = 0x00;
-                            }
+                                while ( !( ( inp == 'j' ) || ( inp == 'n' ) ) ) inp = uart_getc() | 0x20;
 
-                            flags.b.transmit     = 1;
-                            transmission_allowed = 0;
-                            timer1_reset();
-                            timer1_flags |= TIMER_TRANSMITCOUNTER_FLAG;
-                            transmit_flag = 10 * unique_id; // Preload for 100ms delay
-                        }
+                                uart_putc( inp );
+                                uart_puts_P( PSTR( "\r\n" ) );
+
+                                if ( inp == 'j' ) {
+                                    settings_get()->rfm_pwr = rfm_pwr;
+                                    settings_save();
+
+                                    if ( settings_commit() ) {
+                                        uart_puts_P( PSTR( "Speichern erfolgreich!\r\n" ) );
+                                    }
+                                    else {
+                                        uart_puts_P( PSTR( "Speichern fehlgeschlagen!\r\n" ) );
+                                    }
+                                }
+                            }
 
-                        break;
+                        #endif
                     }
 
-                    // Default action (do nothing)
-                    default: {
-                        break;
-                    }
+                    uart_puts( "\n\n\r" );
                 }
 
-                flags.b.lcd_update = 1;
-                flags.b.rx_post    = 1;
-            }
-
-            rfm_rxon();
-            SREG = temp_sreg;
-        }
-
-        // -------------------------------------------------------------------------------------------------------
-
-        // Clear LCD in case of timeouts
-        if ( TRANSMITTER && !flags.b.lcd_update && (   ( clear_lcd_tx_flag > DEL_THRES ) || ( clear_lcd_rx_flag > DEL_THRES )
-                                                   || ( hist_del_flag > ( 3 * DEL_THRES ) ) ) ) {
-            temp_sreg = SREG; // Speichere Statusregister
-            cli();
+                // "aeskey" displays the current key and allows to set a new one
+                if ( uart_strings_equal( uart_field, "aeskey" ) ) {
+                    changes = aesconf();
 
-            if ( clear_lcd_tx_flag > DEL_THRES ) {
-                clear_lcd_tx_flag = 0;
-                lcd_cursorset( 1, 1 );
+                    if ( changes ) {
+                        event_post( EV_RESET );
+                    }
 
-                for ( i = 0; i < 20; i++ ) {
-                    lcd_puts( " " );
+                    changes = 0;
                 }
-            }
-
-            if ( clear_lcd_rx_flag > DEL_THRES ) {
-                clear_lcd_rx_flag = 0;
-                lcd_cursorset( 2, 1 );
 
-                for ( i = 0; i < 20; i++ ) {
-                    lcd_puts( " " );
+                // If valid ignition command was received
+                if ( fire_command_uart_valid( uart_field ) ) {
+                    // Transmit to everybody
+                    tx_field[0]          = FIRE;
+                    tx_field[1]          = uart_field[1];
+                    tx_field[2]          = uart_field[2];
+                    flags.b.transmit     = 1;
+                    transmission_allowed = 1;
+
+                    // Check if ignition was triggered on device that received the serial command
+                    if ( ( slave_id == uart_field[1] ) && !TRANSMITTER ) {
+                        if ( !event_pending( EV_FIRE ) ) {
+                            rx_field[2] = uart_field[2];
+                            loopcount   = 1;
+                            fire_time   = blackbox_time();
+                            fire_local  = BLACKBOX_LOCAL;
+                            event_post( EV_FIRE );
+                        }
+                    }
                 }
-            }
 
-            if ( hist_del_flag > ( DEL_THRES * 3 ) ) {
-                hist_del_flag = 0;
-                lcd_cursorset( 3, 1 );
+                led_yellow_off();
 
-                for ( i = 0; i < 20; i++ ) {
-                    lcd_puts( "  " );
+                if ( uart_field[0] && ( uart_field[0] != 0xFF ) ) {
+                    uart_puts_P( PSTR( "\n\r" ) );
                 }
 
-                anzzeile  = 3;
-                anzspalte = 1;
+                break;
             }
 
-            SREG = temp_sreg;
-        }
-
-        // -------------------------------------------------------------------------------------------------------
+            // -------------------------------------------------------------------------------------------------------
 
-        // Refresh LCD
-        if ( TRANSMITTER && flags.b.lcd_update ) {
-            temp_sreg = SREG;
-            cli();
-
-            flags.b.lcd_update = 0;
-
-            // TRANSMITTER (1. Line + 3./4. Line)
-            if ( flags.b.tx_post ) {
+            // Refresh LCD: TRANSMITTER (1. Line + 3./4. Line)
+            case EV_LCD_TX: {
                 lcd_cursorset( 1, 1 );
                 lcd_puts( "Tx:" );
 
@@ -1372,7 +1427,7 @@ int main( void ) {
                 else {
                     switch ( tx_field[0] ) {
                         case FIRE: {
-                            if ( tx_field[1] && ( tx_field[1] < (MAX_ID+1) ) && tx_field[2] && ( tx_field[2] < 17 ) ) {
+                            if ( tx_field[1] && ( tx_field[1] < (MAX_ID+1) ) && tx_field[2] && ( tx_field[2] <= MAX_CHANNEL ) ) {
                                 lcd_send( 0, 1 );
                                 lcd_puts( " S" );
                                 lcd_arrize( tx_field[1], lcd_array, 2, 0 );
@@ -1394,7 +1449,10 @@ int main( void ) {
                                     lcd_puts( lcd_array );
 
                                     cursor_x_shift( &lastzeile, &lastspalte, &anzzeile, &anzspalte );
+                                    temp_sreg     = SREG;
+                                    cli();
                                     hist_del_flag = 1;
+                                    SREG          = temp_sreg;
                                 }
                             }
 
@@ -1412,7 +1470,10 @@ int main( void ) {
                                 lcd_puts( "xIDENT" );
 
                                 cursor_x_shift( &lastzeile, &lastspalte, &anzzeile, &anzspalte );
+                                temp_sreg     = SREG;
+                                cli();
                                 hist_del_flag = 1;
+                                SREG          = temp_sreg;
                             }
 
                             flags.b.show_only = 0;
@@ -1453,7 +1514,10 @@ int main( void ) {
                                 lcd_puts( "xTEMP " );
 
                                 cursor_x_shift( &lastzeile, &lastspalte, &anzzeile, &anzspalte );
+                                temp_sreg     = SREG;
+                                cli();
                                 hist_del_flag = 1;
+                                SREG          = temp_sreg;
                             }
 
                             flags.b.show_only = 0;
@@ -1484,18 +1548,21 @@ int main( void ) {
                     }
                 }
 
-                flags.b.tx_post   = 0;
                 clear_lcd_tx_flag = 1;
+
+                break;
             }
 
-            // RECEIVER (2. Line)
-            if ( flags.b.rx_post ) {
+            // -------------------------------------------------------------------------------------------------------
+
+            // Refresh LCD: RECEIVER (2. Line)
+            case EV_LCD_RX: {
                 lcd_cursorset( 2, 1 );
                 lcd_puts( "Rx:" );
 
                 switch ( rx_field[0] ) {
                     case FIRE: {
-                        if ( rx_field[1] && ( rx_field[1] < (MAX_ID+1) ) && rx_field[2] && ( rx_field[2] < 17 ) ) {
+                        if ( rx_field[1] && ( rx_field[1] < (MAX_ID+1) ) && rx_field[2] && ( rx_field[2] <= MAX_CHANNEL ) ) {
                             lcd_send( 0, 1 );
                             lcd_puts( " S" );
                             lcd_arrize( rx_field[1], lcd_array, 2, 0 );
@@ -1599,17 +1666,536 @@ int main( void ) {
                         break;
                     }
 
+                    case IMPREPORT: {
+                        lcd_puts( "U" );   // Unique-ID
+                        lcd_arrize( rx_field[1], lcd_array, 2, 0 );
+                        lcd_puts( lcd_array );
+                        lcd_puts( " OK" ); // Channels with continuity
+                        lcd_arrize( impreport_count( rx_field ), lcd_array, 2, 0 );
+                        lcd_puts( lcd_array );
+                        lcd_puts( "/" );   // Reported channels
+                        lcd_arrize( rx_field[2] & ~IMPREPORT_FULL, lcd_array, 2, 0 );
+                        lcd_puts( lcd_array );
+                        lcd_puts( "   -" );
+
+                        if ( !rssi ) {
+                            lcd_puts( "--" );
+                        }
+                        else {
+                            lcd_arrize( ( ( rssi > 99 ) ? 99 : rssi ), lcd_array, 2, 0 );
+                            lcd_puts( lcd_array );
+                        }
+
+                        break;
+                    }
+
                     default: {
                         break;
                     }
                 }
 
-                flags.b.rx_post   = 0;
                 clear_lcd_rx_flag = 1;
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // Clear LCD in case of timeouts (posted by Timer 0)
+            case EV_LCD_CLEAR: {
+                // Find out which lines are due
+                temp_sreg = SREG;
+                cli();
+                tmp       = 0;
+
+                if ( clear_lcd_tx_flag > DEL_THRES ) {
+                    clear_lcd_tx_flag = 0;
+                    tmp              |= 1;
+                }
+
+                if ( clear_lcd_rx_flag > DEL_THRES ) {
+                    clear_lcd_rx_flag = 0;
+                    tmp              |= 2;
+                }
+
+                if ( hist_del_flag > ( DEL_THRES * 3 ) ) {
+                    hist_del_flag = 0;
+                    tmp          |= 4;
+                }
+
+                SREG = temp_sreg;
+
+                if ( tmp & 1 ) {
+                    lcd_cursorset( 1, 1 );
+
+                    for ( i = 0; i < 20; i++ ) {
+                        lcd_puts( " " );
+                    }
+                }
+
+                if ( tmp & 2 ) {
+                    lcd_cursorset( 2, 1 );
+
+                    for ( i = 0; i < 20; i++ ) {
+                        lcd_puts( " " );
+                    }
+                }
+
+                if ( tmp & 4 ) {
+                    lcd_cursorset( 3, 1 );
+
+                    for ( i = 0; i < 20; i++ ) {
+                        lcd_puts( "  " );
+                    }
+
+                    anzzeile  = 3;
+                    anzspalte = 1;
+                }
+
+                break;
             }
 
-            SREG = temp_sreg;
+            // -------------------------------------------------------------------------------------------------------
+
+            // Slave- and Unique-ID settings
+            case EV_CONFIG: {
+                changes = configprog( ig_or_notrans );
+
+                if ( changes ) {
+                    event_post( EV_RESET );
+                }
+
+                changes = 0;
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // Remote Slave- and Unique-ID settings
+            case EV_REMOTE: {
+                changes = 0;
+                changes = remote_config( tx_field );
+
+                if ( changes ) {
+                    // If the numbers are those of the connected device
+                    if ( ( tx_field[1] == unique_id ) && ( tx_field[2] == slave_id ) ) {
+                        uart_puts_P( PSTR( "\n\rIDs werden lokal angepasst!\n\r" ) );
+                        addresses_save( tx_field[3], tx_field[4] );
+                        event_post( EV_RESET );
+                    }
+                    // If not...
+                    else {
+                        uart_puts_P( PSTR( "\n\rID-Konfigurationsbefehl wird gesendet!\n\r" ) );
+                        flags.b.transmit = 1;
+                    }
+
+                    uart_puts_P( PSTR( "\n\n\r" ) );
+                }
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // Manual transmission
+            case EV_SEND: {
+                nr = 0, tmp = 0, inp = 0;
+
+                switch ( uart_field[0] ) {
+                    case FIRE:
+                    case IDENT:
+                    case IDENT_REFRESH:
+                    case TEMPERATURE:
+                    case MEASURE:
+                    case STANDBY:
+                    case WAKEUP: {
+                        inp = uart_field[0];
+                        break;
+                    }
+
+                    default: {
+                        uart_puts_P( PSTR( "\n\rModus(f/i/r/t/m/l/x/b/w): " ) );
+
+                        while ( !inp ) inp = uart_getc() | 0x20;
+
+                        uart_putc( inp );
+                        uart_puts_P( PSTR( "\r\n" ) );
+                        break;
+                    }
+                }
+
+                tx_field[0] = inp;
+
+                if (  ( tx_field[0] == FIRE ) || ( tx_field[0] == IDENT ) || ( tx_field[0] == IDENT_REFRESH ) || ( tx_field[0] == TEMPERATURE )
+                   || ( tx_field[0] == MEASURE ) || ( tx_field[0] == LOGREQUEST ) || ( tx_field[0] == MEMREQUEST )
+                   || ( tx_field[0] == STANDBY ) || ( tx_field[0] == WAKEUP ) ) {
+                    // Assume, that a transmission shall take place
+                    tmp = 1;
+
+                    // Handle slave-id and channel input
+                    switch ( tx_field[0] ) {
+                        case FIRE: {
+                            for ( uint8_t round = 1; round < 3; round++ ) {                                  // Loop twice
+                                nr = 0;
+                                uart_puts_P( round < 2 ? PSTR( "Slave-ID:\t" ) : PSTR( "\n\rKanal:  \t" ) ); // First for slave-id, then for channel
+
+                                for ( i = 0; i < 2; i++ ) {                                 // Get the user to assign the numbers with 2 digits
+                                    inp = 0;
+
+                                    while ( !inp ) inp = uart_getc();
+
+                                    uart_putc( inp );
+                                    nr *= 10;
+                                    nr += ( inp - '0' );
+                                }
+
+                                uart_puts_P( PSTR( " = " ) );
+
+                                if ( ( nr > 0 ) && ( nr < ( ( round < 2 ) ? (MAX_ID+1) : (MAX_CHANNEL+1) ) ) ) { // Slave-ID has to be 1-MAX_ID, Channel 1-MAX_CHANNEL
+                                    uart_shownum( nr, 'd' );
+                                    tx_field[round] = nr;
+                                }
+                                else {                                                      // Otherwise the input's invalid
+                                    uart_puts_P( PSTR( "Ungültige Eingabe" ) );
+                                    tmp   = 0;                                              // Sending gets disallowed
+                                    round = 3;
+                                }
+                            }
+
+                            break;
+                        }
+
+                        case IDENT: {
+                            tx_field[0] = IDENT;
+                            tx_field[1] = IDENT_FULL;
+                            tx_field[2] = ++ident_epoch;
+                            break;
+                        }
+
+                        // Refresh within the epoch of the last full identification
+                        case IDENT_REFRESH: {
+                            tx_field[0] = IDENT;
+                            tx_field[1] = IDENT_DELTA;
+                            tx_field[2] = ident_epoch;
+                            break;
+                        }
+
+                        case TEMPERATURE: {
+                            tempmeas( tempsenstype, temperature );
+
+                            uart_puts_P( PSTR( "Temperatur: " ) );
+
+                            for ( i = 0; i < TEMP_SENSORS; i++ ) {
+                                if ( i ) {
+                                    uart_puts_P( PSTR( ", " ) );
+                                }
+
+                                if ( temperature[i] == -128 ) {
+                                    uart_puts_P( PSTR( "n.a." ) );
+                                }
+                                else {
+                                    fixedspace( temperature[i], 'd', 4 );
+                                    uart_puts_P( PSTR( "°C" ) );
+                                }
+                            }
+
+                            // Request other devices to refresh temperature as well
+                            tx_field[0] = TEMPERATURE;
+                            tx_field[1] = 'e';
+                            tx_field[2] = 'm';
+                            tx_field[3] = 'p';
+                            break;
+                        }
+
+                        // Request event log or RAM usage of one box
+                        case LOGREQUEST:
+                        case MEMREQUEST: {
+                            nr = 0;
+                            uart_puts_P( PSTR( "Unique-ID:\t" ) );
+
+                            for ( i = 0; i < 2; i++ ) {
+                                inp = 0;
+
+                                while ( !inp ) inp = uart_getc();
+
+                                uart_putc( inp );
+                                nr *= 10;
+                                nr += ( inp - '0' );
+                            }
+
+                            uart_puts_P( PSTR( " = " ) );
+
+                            if ( ( nr > 0 ) && ( nr < (MAX_ID+1) ) ) {
+                                uart_shownum( nr, 'd' );
+                                tx_field[1] = nr;
+                                tx_field[2] = 0;
+                            }
+                            else {
+                                uart_puts_P( PSTR( "Ungültige Eingabe" ) );
+                                tmp = 0;
+                            }
+
+                            break;
+                        }
+
+                        // Request compact impedance report of one box
+                        case MEASURE: {
+                            nr = 0;
+                            uart_puts_P( PSTR( "Unique-ID:\t" ) );
+
+                            for ( i = 0; i < 2; i++ ) {
+                                inp = 0;
+
+                                while ( !inp ) inp = uart_getc();
+
+                                uart_putc( inp );
+                                nr *= 10;
+                                nr += ( inp - '0' );
+                            }
+
+                            uart_puts_P( PSTR( " = " ) );
+
+                            if ( ( nr > 0 ) && ( nr < (MAX_ID+1) ) ) {
+                                uart_shownum( nr, 'd' );
+                                tx_field[1] = nr;
+                                tx_field[2] = IMPREPORT;
+                            }
+                            else {
+                                uart_puts_P( PSTR( "Ungültige Eingabe" ) );
+                                tmp = 0;
+                            }
+
+                            break;
+                        }
+
+                        default: {
+                            break;
+                        }
+                    }
+                }
+
+                uart_puts_P( PSTR( "\n\n\r" ) );
+
+                // Take action after proper command
+                if ( tmp ) {
+                    flags.b.transmit     = 1;
+                    transmission_allowed = 1;
+
+                    if ( ( tx_field[0] == FIRE ) && ( slave_id == tx_field[1] ) ) {
+                        rx_field[2] = tx_field[2];
+                        fire_time   = blackbox_time();
+                        fire_local  = BLACKBOX_LOCAL;
+                        event_post( EV_FIRE );
+                    }
+                }
+                else {
+                    flags.b.transmit = 0;
+                }
+
+                while ( UCSR0A & ( 1 << RXC0 ) ) inp = UDR0;
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // Hardware
+            case EV_HW: {
+                uart_puts_P( PSTR( "\n\r" ) );
+                uart_puts( ig_or_notrans ? "Zündbox v1/v2" : "Transmitter" );
+                uart_puts_P( PSTR( "\n\r" ) );
+                uart_puts_P( PSTR( STRINGIZE_VALUE_OF( MCU ) ) );
+                uart_puts_P( PSTR( "\n\rRFM" ) );
+                uart_shownum( RFM, 'd' );
+                #if defined COMPILEDATE && defined COMPILETIME
+                    uart_puts_P( PSTR( "\n\r" ) );
+                    uart_puts_P( PSTR( "Datecode " ) );
+                    uart_puts_P( PSTR( STRINGIZE_VALUE_OF( COMPILEDATE ) ) );
+                    uart_puts_P( PSTR( STRINGIZE_VALUE_OF( COMPILETIME ) ) );
+                #endif
+                uart_puts_P( PSTR( "\n\n\r" ) );
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // List network devices, one entry per event
+            case EV_LIST: {
+                tmp = slaves.count ? slaves.count : 1; // Calls for the boxes (only one if none reported)
+
+                if ( list_pos < tmp ) {
+                    list_complete( &slaves, iderrors, list_pos );
+                }
+                else {
+                    // Skip Slave-IDs without boxes
+                    while ( ( list_sid < MAX_ID ) && !slaves.quantity[list_sid] ) {
+                        list_sid++;
+                    }
+
+                    list_array( slaves.quantity, list_sid, list_pos - tmp );
+
+                    if ( list_sid++ >= MAX_ID ) {
+                        break;
+                    }
+                }
+
+                list_pos++;
+                event_post( EV_LIST );
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // List continuity table, one box per event
+            case EV_LIST_IMP: {
+                list_continuity( &imptable, imp_listpos );
+
+                if ( ++imp_listpos < imptable.count ) {
+                    event_post( EV_LIST_IMP );
+                }
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // Temperature conversion is complete (posted by Timer 1) or a scratchpad has been read (posted by the bus),
+            // the sensors are read one after the other
+            case EV_TEMP: {
+                if ( temp_read_req.done ) {
+                    temp_read_req.done      = 0;
+                    temperature[temp_index] = temp_result( temp_read_req.result );
+
+                    if ( ++temp_index < temp_sensors ) {
+                        event_post( EV_TEMP );
+                    }
+                    else {
+                        event_post( EV_STATUS );
+                    }
+                }
+                else if ( ( temp_index < temp_sensors ) && !temp_read_req.busy ) {
+                    temp_read_req.id = temp_id( temp_index );
+
+                    if ( !w1_request( &temp_read_req ) ) {
+                        event_post_in( EV_TEMP, 1 ); // Bus queue full, try again
+                    }
+                }
+
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // Push STATUS if arm state, battery or temperature changed since the last report (posted by Timer 1 for
+            // sampling and at the end of the backoff, by the key switch and after a temperature readout)
+            case EV_STATUS: {
+                uint8_t later;
+
+                // Battery first, the ADC must not wait while the 1-Wire bus runs the conversion queued below
+                tmp = ( TRANSMITTER || !ident_last.valid ) ? 0 : adc_read( 5 );
+
+                // Periodic sampling: start temperature conversion, EV_TEMP posts EV_STATUS again with the new values
+                if ( status_sample ) {
+                    status_sample = 0;
+
+                    if ( temp_start( tempsenstype ) ) {
+                        event_post_in( EV_TEMP, TEMP_CONV_TICKS );
+                    }
+                }
+
+                // Only boxes that replied to IDENT before push their status
+                if ( TRANSMITTER || !ident_last.valid ) {
+                    break;
+                }
+
+                if ( !ident_changed( &ident_last, armed, tmp, temperature ) ) {
+                    flags.b.status_pending = 0;
+                    break;
+                }
+
+                // Due once the backoff is over, not within the holdoff and only if no other message waits for its slot
+                temp_sreg = SREG;
+                cli();
+                later = !flags.b.status_pending || event_scheduled( EV_STATUS ) || status_holdoff || flags.b.transmit;
+
+                if ( later && !event_scheduled( EV_STATUS ) ) {
+                    event_post_in( EV_STATUS, status_holdoff + STATUS_BACKOFF_MIN + status_random() % STATUS_BACKOFF_SPREAD );
+                }
+
+                SREG = temp_sreg;
+
+                flags.b.status_pending = 1;
+
+                if ( later ) {
+                    break;
+                }
+
+                flags.b.status_pending = 0;
+                ident_remember( &ident_last, armed, tmp, temperature );
+
+                tx_field[0] = STATUS;
+                tx_field[1] = unique_id;
+                tx_field[2] = slave_id;
+                tx_field[3] = tmp;
+                tx_field[4] = armed;
+                temp_to_frame( &tx_field[5], temperature );
+
+                temp_sreg      = SREG;
+                cli();
+                status_holdoff = STATUS_HOLDOFF;
+                SREG           = temp_sreg;
+
+                flags.b.transmit     = 1;
+                transmission_allowed = 1;
+                break;
+            }
+
+            // -------------------------------------------------------------------------------------------------------
+
+            // List event log, one entry per event (oldest first)
+            case EV_LOG: {
+                blackbox_entry_t entry;
+
+                if ( !log_pos ) {
+                    uart_puts_P( PSTR( "\n\n\rEreignisprotokoll\n\r" ) );
+                    uart_puts_P( PSTR( "=================\n\r" ) );
+                }
+
+                if ( blackbox_read( log_pos, &entry ) ) {
+                    list_blackbox( unique_id, &entry );
+                }
+
+                if ( ++log_pos < BLACKBOX_ENTRIES ) {
+                    event_post( EV_LOG );
+                }
+                else {
+                    uart_puts_P( PSTR( "\n\n\r" ) );
+                }
+
+                break;
+            }
+
+            // Nothing to do
+            default: {
+                break;
+            }
         }
+
+        PROF_STOP( prof_section( event ), prof_start );
+
+        // -------------------------------------------------------------------------------------------------------
+
+        // Nothing left to do: sleep until the next interrupt (Timer 1 wakes up the loop every 10ms at the latest)
+        cli();
+
+        if ( !event_any() && !lcd_pending() && !( blackbox_ready() && !flags.b.is_fire_active ) ) {
+            idle_sleep();
+        }
+
+        sei();
     }
 
     // -------------------------------------------------------------------------------------------------------
@@ -1619,14 +2205,27 @@ int main( void ) {
 
 // Interrupt vectors
 ISR( TIMER1_COMPA_vect ) { // Occurs every 10ms if active
-    if ( timer1_flags & TIMER_TRANSMITCOUNTER_FLAG ) {
-        transmit_flag++;
+    leds_tick();
+    key_sample();
+    clock_tick();
+    event_tick();
+    idle_tick();
+
+    // Status sampling
+    if ( ++status_ticks >= STATUS_SAMPLE_TICKS ) {
+        status_ticks  = 0;
+        status_sample = 1;
+        event_post( EV_STATUS );
+    }
+
+    if ( status_holdoff ) {
+        status_holdoff--;
     }
 
     // -------------------------------------------------------------------------------------------------------
 
     if ( active_channels ) {
-        channel_monitor = 1; // Set a reminder to monitor the channels
+        event_post( EV_PULSE ); // Monitor the channels
     }
 }
 
@@ -1654,8 +2253,9 @@ ISR( TIMER0_OVF_vect ) {
     if ( hist_del_flag > 10000 ) {
         hist_del_flag = 0;
     }
-}
 
-ISR( KEYINT ) {
-    key_flag = 1;
+    // Some line of the LCD is due to be cleared
+    if ( ( clear_lcd_tx_flag > DEL_THRES ) || ( clear_lcd_rx_flag > DEL_THRES ) || ( hist_del_flag > ( 3 * DEL_THRES ) ) ) {
+        event_post( EV_LCD_CLEAR );
+    }
 }
@@ -9,6 +9,9 @@
 
 #ifdef RFM69_H_
 
+// Listen Mode selected (rfm_standby()) and currently running
+    static uint8_t rfm_listen_selected = 0, rfm_listening = 0;
+
 // SPI-Transfer
     static inline uint8_t rfm_spi( uint8_t spibyte ) {
         #if (HARDWARE_SPI_69)
@@ -73,8 +76,8 @@
         uint16_t status;
         status = rfm_status();
 
-        // No Payload and RSSI-Rx-Timeout -> Rx-Restart
-        if ( ( !( status & ( 1 << 2 ) ) ) && ( status & ( 1 << 10 ) ) ) {
+        // No Payload and RSSI-Rx-Timeout -> Rx-Restart (Listen Mode goes back to idle on its own)
+        if ( !rfm_listening && ( !( status & ( 1 << 2 ) ) ) && ( status & ( 1 << 10 ) ) ) {
             rfm_cmd( ( rfm_cmd( 0x3DFF, 0 ) | 0x3D04 ), 1 );
         }
 
@@ -140,55 +143,90 @@
         rfm_cmd( 0x2810, 1 );
     }
 
+// Wait until the bits of mask in register reg equal value, returns 0 if they do and 1 on timeout
+    static uint8_t rfm_wait( uint8_t reg, uint8_t mask, uint8_t value, uint32_t timeout_us ) {
+        uint32_t deadline = clock_deadline( timeout_us );
+
+        while ( ( rfm_cmd( (uint16_t) reg << 8, 0 ) & mask ) != value ) {
+            if ( clock_expired( deadline ) ) {
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+// ------------------------------------------------------------------------------------------------------------------------
+
+// Leave Listen Mode, the module is in standby afterwards
+    static void rfm_listen_abort( void ) {
+        if ( rfm_listening ) {
+            rfm_cmd( 0x0124, 1 );                                          // ListenAbort while ListenOn gets cleared
+            rfm_cmd( 0x0104, 1 );                                          // Standby
+            rfm_listening = 0;
+        }
+    }
+
+// Select Listen Mode for receiving: the module switches between receiving and idling on its own and keeps a received
+// packet until it is read (or until the next receive period)
+    void rfm_standby( uint8_t on ) {
+        rfm_listen_selected = on;
+    }
+
+    uint8_t rfm_standby_active( void ) {
+        return rfm_listen_selected;
+    }
+
 // ------------------------------------------------------------------------------------------------------------------------
 
 // Turn Transmitter on and off
     uint8_t rfm_txon( void ) {
-        uint32_t utimer = RFM69_TIMEOUTVAL;
+        rfm_listen_abort();
         rfm_cmd( 0x010C, 1 );                                          // TX on (set to transmitter mode in RegOpMode)
 
-        while ( --utimer && !( rfm_cmd( 0x27FF, 0 ) & ( 1 << 7 ) ) );  // Wait for Mode-Ready- and TX-Ready-Flag
-
-        return utimer ? 0 : 1;
+        return rfm_wait( 0x27, 1 << 7, 1 << 7, RFM69_TIMEOUT_US );     // Wait for Mode-Ready- and TX-Ready-Flag
     }
 
     uint8_t rfm_txoff( void ) {
-        uint32_t utimer = RFM69_TIMEOUTVAL;
         rfm_cmd( 0x0104, 1 );                                          // TX off (set to standby mode in RegOpMode)
 
-        while ( --utimer && !( rfm_cmd( 0x27FF, 0 ) & ( 1 << 7 ) ) );  // Wait for Mode-Ready-Flag
-
-        return utimer ? 0 : 1;
+        return rfm_wait( 0x27, 1 << 7, 1 << 7, RFM69_TIMEOUT_US );     // Wait for Mode-Ready-Flag
     }
 
 // Turn Receiver on and off
     uint8_t rfm_rxon( void ) {
-        uint32_t utimer = RFM69_TIMEOUTVAL;
+        uint8_t timeout;
+        rfm_listen_abort();
+
+        if ( rfm_listen_selected ) {
+            rfm_cmd( 0x0104, 1 );                                      // Listen Mode has to be entered from standby
+
+            timeout = rfm_wait( 0x27, 1 << 7, 1 << 7, RFM69_TIMEOUT_US );
+
+            rfm_cmd( 0x0144, 1 );                                      // ListenOn
+            rfm_listening = 1;
+
+            return timeout;
+        }
+
         rfm_cmd( ( rfm_cmd( 0x3DFF, 0 ) | 0x3D04 ), 1 );
         rfm_cmd( 0x0110, 1 );                                          // RX on (set to receiver mode in RegOpMode)
 
-        while ( --utimer && !( rfm_cmd( 0x27FF, 0 ) & ( 1 << 7 ) ) );  // Wait for Mode-Ready--Flag
-
-        return utimer ? 0 : 1;
+        return rfm_wait( 0x27, 1 << 7, 1 << 7, RFM69_TIMEOUT_US );     // Wait for Mode-Ready--Flag
     }
 
     uint8_t rfm_rxoff( void ) {
-        uint32_t utimer = RFM69_TIMEOUTVAL;
+        rfm_listen_abort();
         rfm_cmd( 0x0104, 1 );                                          // RX off (set to standby mode in RegOpMode)
 
-        while ( --utimer && !( rfm_cmd( 0x27FF, 0 ) & ( 1 << 7 ) ) );  // Wait for Mode-Ready-Flag
-
-        return utimer ? 0 : 1;
+        return rfm_wait( 0x27, 1 << 7, 1 << 7, RFM69_TIMEOUT_US );     // Wait for Mode-Ready-Flag
     }
 
 // Get RSSI-Value
     uint8_t rfm_get_rssi_dbm( void ) {
-        uint32_t utimer = RFM69_TIMEOUTVAL;
-
         if ( !rfm_cmd( 0x6FFF, 0 ) ) {
             rfm_cmd( 0x2301, 1 );
-
-            while ( --utimer && !( rfm_cmd( 0x23FF, 0 ) & ( 1 << 1 ) ) );
+            rfm_wait( 0x23, 1 << 1, 1 << 1, RFM69_TIMEOUT_US );
         }
 
         return rfm_cmd( 0x24FF, 0 ) >> 1;
@@ -242,8 +280,7 @@
 
 // Initialise RFM
     void rfm_init( void ) {
-        uint32_t utimer;
-        uint8_t  timeoutval;
+        uint8_t timeoutval;
         // Configure SPI inputs and outputs
         NSEL_PORT |= ( 1 << NSEL );
         SDO_PORT  |= ( 1 << SDO );
@@ -303,20 +340,25 @@
             rfm_cmd( 0x2B00 | ( timeoutval >> 1 ), 1 );                                                               // Timeout after RSSI-Interrupt if no
                                                                                                                       // Payload-Ready-Interrupt occurs
             rfm_cmd( 0x1180 | ( P_OUT & 0x1F ), 1 );                                                                  // Set Output Power
+            // Listen Mode
+            rfm_cmd( 0x0D94, 1 );                                                                                     // Idle 4.1ms, Rx 64us resolution,
+                                                                                                                      // RSSI criterion, keep listening
+                                                                                                                      // after PayloadReady
+            rfm_cmd( 0x0E00 | RFM69_LISTEN_IDLE, 1 );                                                                 // Idle time
+            rfm_cmd( 0x0F00 | RFM69_LISTEN_RX, 1 );                                                                   // Rx time
         }
 
         rfm_cmd( 0x0A80, 1 );                                          // Start RC-Oscillator
-        utimer = RFM69_TIMEOUTVAL;
-
-        while ( --utimer && !( rfm_cmd( 0x0A00, 0 ) & ( 1 << 6 ) ) );  // Wait for RC-Oscillator
+        rfm_wait( 0x0A, 1 << 6, 1 << 6, RFM69_TIMEOUT_US );            // Wait for RC-Oscillator
 
         rfm_rxon();
     }
 
 // Transmit data stream
     uint8_t rfm_transmit( char *data, uint8_t length ) {
-        uint32_t utimer = RFM69_TIMEOUTVAL;
-        char     fifoarray[MAX_COM_ARRAYSIZE + 1];
+        char    fifoarray[MAX_COM_ARRAYSIZE + 1];
+        uint8_t timeout;
+        PROF_START( prof_start );
 
         // Turn off receiver, switch to Standby
         rfm_rxoff();
@@ -342,18 +384,18 @@
         rfm_txon();
 
         // Wait for Package Sent (150 Byte-Times)
-        utimer = ( ( 75 * F_CPU + BR * 8 ) / ( 16 * BR ) );
-
-        while ( --utimer && ( ( rfm_cmd( 0x2800, 0 ) & 0x09 ) != 0x08 ) );  // Check for package sent and module plugged in
+        timeout = rfm_wait( 0x28, 0x09, 0x08, RFM69_TX_TIMEOUT_US );  // Check for package sent and module plugged in
 
         rfm_txoff();
-        return utimer ? 0 : 1;                                              // 0 : successful, 1 : error
+        PROF_STOP( PROF_RFM_TX, prof_start );
+        return timeout;                                             // 0 : successful, 1 : error
     }
 
 // Receive data stream
     uint8_t rfm_receive( char *data, uint8_t *length ) {
         char    fifoarray[MAX_COM_ARRAYSIZE + 1];
         uint8_t length_local;
+        PROF_START( prof_start );
 
         // Turn off receiver, switch to Standby
         rfm_rxoff();
@@ -380,6 +422,7 @@
 
         // Write local variable to pointer
         *length = length_local;
+        PROF_STOP( PROF_RFM_RX, prof_start );
 
         // Return value is for compatibility reasons with RFM12
         // It's always 0 because PayloadReady only occurs after successful hardware CRC
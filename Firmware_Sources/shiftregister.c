@@ -55,35 +55,33 @@ void sr_disable( void ) {
     OE_PORT |= ( 1 << OE );
 }
 
-// Transfer 16 bit pattern to outputs
-void sr_shiftout( uint16_t scheme ) {
+// Transfer channel pattern to outputs, highest channel first
+void sr_shiftout( chanset_t scheme ) {
     SER_IN_PORT &= ~( 1 << SER_IN );
     SCLOCK_PORT &= ~( 1 << SCLOCK );
     RCLOCK_PORT &= ~( 1 << RCLOCK );
 
-    #if HARDWARE_SPI_SR
-        SPDR = ( scheme >> 8 ) & 0xFF;
-
-        while ( !( SPSR & ( 1 << SPIF ) ) );
+    for ( uint8_t i = SR_BYTES; i; i-- ) {
+        uint8_t pattern = chanset_byte( scheme, i - 1 );
 
-        SPDR = scheme & 0xFF;
+        #if HARDWARE_SPI_SR
+            SPDR = pattern;
 
-        while ( !( SPSR & ( 1 << SPIF ) ) );
+            while ( !( SPSR & ( 1 << SPIF ) ) );
 
-    #else
-        uint16_t mask = 1 << ( SR_CHANNELS - 1 );
+        #else
+            for ( uint8_t mask = 0x80; mask; mask >>= 1 ) {
+                if ( pattern & mask ) {
+                    SER_IN_PORT |= 1 << SER_IN;
+                }
 
-        for ( uint8_t i = SR_CHANNELS; i; i-- ) {
-            if ( scheme & mask ) {
-                SER_IN_PORT |= 1 << SER_IN;
+                SCLOCK_PIN   = ( 1 << SCLOCK ); // Pin high after toggling
+                SCLOCK_PIN   = ( 1 << SCLOCK ); // Pin low after toggling
+                SER_IN_PORT &= ~( 1 << SER_IN );
             }
+        #endif
+    }
 
-            SCLOCK_PIN   = ( 1 << SCLOCK ); // Pin high after toggling
-            SCLOCK_PIN   = ( 1 << SCLOCK ); // Pin low after toggling
-            SER_IN_PORT &= ~( 1 << SER_IN );
-            mask       >>= 1;
-        }
-    #endif
     RCLOCK_PIN = ( 1 << RCLOCK ); // Pin high after toggling
     RCLOCK_PIN = ( 1 << RCLOCK ); // Pin low after toggling
 }
\ No newline at end of file
@@ -16,20 +16,58 @@
 #define SCLOCK_P            C
 #define SCLOCK_NUM          3
 
-// How many channels? (8 or 16)
-// For 16 the SER_IN of the 74HC595 for channels 9-16
-// has to be connected to Q7S of the 74HC595 for channels 1-8
-#define SR_CHANNELS         16
+// How many channels? (8, 16, 24, 32, 48 or 64)
+// For more than 8 the SER_IN of the 74HC595 for channels 9-16
+// has to be connected to Q7S of the 74HC595 for channels 1-8 and so on
+#ifndef SR_CHANNELS
+    #define SR_CHANNELS     16
+#endif
 
 /* Use Hardware-SPI if available? */
 #define SR_USE_HARDWARE_SPI 0
 
 // DO NOT CHANGE ANYTHING BELOW THIS LINE!
 
+#if ( SR_CHANNELS % 8 ) || ( SR_CHANNELS > 64 )
+    #error "SR_CHANNELS has to be a multiple of 8 and must not exceed 64!"
+#endif
+
+#define SR_BYTES            ( SR_CHANNELS / 8 )
+
+// Set of channels, one bit per channel (bit 0 = channel 1). The type is the narrowest
+// integer holding SR_CHANNELS bits, so small boxes don't pay for 32 or 64 bit arithmetic.
+#if SR_CHANNELS <= 8
+    typedef uint8_t chanset_t;
+#elif SR_CHANNELS <= 16
+    typedef uint16_t chanset_t;
+#elif ( SR_CHANNELS <= 24 ) && defined( __UINT24_MAX__ )
+    typedef __uint24 chanset_t;
+#elif SR_CHANNELS <= 32
+    typedef uint32_t chanset_t;
+#else
+    typedef uint64_t chanset_t;
+#endif
+
+// Byte-wise access to channel sets (channel numbers are zero based here),
+// single channel operations thus stay 8 bit wide for every channel count
+static inline uint8_t chanset_byte( chanset_t set, uint8_t byte ) {
+    return ( (uint8_t *) &set )[byte];
+}
+
+static inline chanset_t chanset_bit( uint8_t channel ) {
+    chanset_t set = 0;
+    ( (uint8_t *) &set )[channel >> 3] = 1 << ( channel & 7 );
+    return set;
+}
+
+static inline uint8_t chanset_test( chanset_t set, uint8_t channel ) {
+    return chanset_byte( set, channel >> 3 ) & ( 1 << ( channel & 7 ) );
+}
+
 void sr_init( void );
 void sr_enable( void );
 void sr_disable( void );
-void sr_shiftout( uint16_t scheme );
+void sr_shiftout( chanset_t scheme );
 
 // Generation of names
 #define SER_IN_PORT         PORT( SER_IN_P )
@@ -248,7 +248,7 @@ uint8_t configprog( const uint8_t devicetype ) {
         if ( changes ) {
             addresses_save( uniqueid, slaveid );
 
-            if ( address_valid( uniqueid, slaveid ) ) {
+            if ( settings_commit() ) {
                 uart_puts_P( PSTR( "\n\n\rÄnderung erfolgreich!\n\r" ) );
             }
             else {
@@ -286,7 +286,7 @@ uint8_t aesconf( void ) {
         }
         uart_puts_P( PSTR( "\r\nSchlüssel lt. EEPROM:    " ) );
         for ( uint8_t i = 0; i < 16; i++ ) {
-            uart_shownum( eeread( START_ADDRESS_AESKEY_STORAGE + i ), 'h' );
+            uart_shownum( settings_get()->aeskey[i], 'h' );
             uart_puts_P( PSTR( " " ) );
         }
         uart_puts_P( PSTR( "\r\n\nNeuen (S)chlüssel eingeben, Abbruch mit beliebiger anderer Taste! " ) );
@@ -328,8 +328,16 @@ uint8_t aesconf( void ) {
 
             if ( choice == 'j' ) {
                 for ( uint8_t i = 0; i < 16; i++ ) {
-                    eewrite( aesvalues[i], START_ADDRESS_AESKEY_STORAGE + i );
+                    settings_get()->aeskey[i] = aesvalues[i];
                 }
+
+                settings_save();
+
+                if ( !settings_commit() ) {
+                    uart_puts_P( PSTR( "\r\nSpeichern fehlgeschlagen!\r\n\n" ) );
+                    return 0;
+                }
+
                 uart_puts_P( PSTR( "\r\nErfolgreich gespeichert, Device startet neu!\r\n\n" ) );
                 return 1;
             }
@@ -346,46 +354,47 @@ uint8_t aesconf( void ) {
 }
 
 
-// List ignition devices
-void list_complete( fireslave_t slaves[MAX_ID + 1], uint8_t wrongids ) {
-    uint8_t i = 0, ganz, zehntel;
+// List ignition devices that reported, one box per call (header with the first, error count with the last box;
+// with an empty table the only call shows both)
+void list_complete( const slavetable_t *table, uint8_t wrongids, uint8_t i ) {
+    const fireslave_t *box = &table->box[i];
+    uint8_t            ganz, zehntel;
 
-    terminal_reset();
-    uart_puts_P( PSTR( TERM_COL_YELLOW ) );
-    uart_puts_P( PSTR( "\n\rSystemübersicht\n\r" ) );
-    uart_puts_P( PSTR( "===============\n\r" ) );
+    if ( !i ) {
+        terminal_reset();
+        uart_puts_P( PSTR( TERM_COL_YELLOW ) );
+        uart_puts_P( PSTR( "\n\rSystemübersicht\n\r" ) );
+        uart_puts_P( PSTR( "===============\n\r" ) );
 
-    uart_puts_P( PSTR( TERM_COL_WHITE ) );
-    uart_puts_P( PSTR( "\n\rUnique-ID: Slave-ID, Batteriespannung (V), Scharf?, Temperatur (°C), RSSI (dBm)\n\r" ) );
+        uart_puts_P( PSTR( TERM_COL_WHITE ) );
+        uart_puts_P( PSTR( "\n\rUnique-ID: Slave-ID, Batteriespannung (V), Scharf?, Temperatur (°C), RSSI (dBm)\n\r" ) );
+    }
 
-    while ( i < MAX_ID ) {
+    if ( !table->count ) {
+        uart_puts_P( PSTR( "Keine Boxen gemeldet\n\r" ) );
+    }
+    else {
         // Show Unique-ID
-        if ( ( i + 1 ) < 10 ) {
+        if ( box->unique_id < 10 ) {
             uart_puts_P( PSTR( "0" ) );
         }
 
-        uart_shownum( i + 1, 'd' );
+        uart_shownum( box->unique_id, 'd' );
         uart_puts_P( PSTR( ": " ) );
 
         // Show Slave-ID
-        if ( !slaves[i].slave_id ) {
-            uart_puts_P( PSTR( "---" ) );
-        }
-        else {
-            uart_puts_P( PSTR( " " ) );
-
-            if ( slaves[i].slave_id < 10 ) {
-                uart_puts_P( PSTR( "0" ) );
-            }
+        uart_puts_P( PSTR( " " ) );
 
-            uart_shownum( slaves[i].slave_id, 'd' );
+        if ( box->slave_id < 10 ) {
+            uart_puts_P( PSTR( "0" ) );
         }
 
+        uart_shownum( box->slave_id, 'd' );
         uart_puts_P( PSTR( ", " ) );
 
         // Show Battery Voltages
-        ganz    = slaves[i].battery_voltage / 10;
-        zehntel = slaves[i].battery_voltage % 10;
+        ganz    = box->battery_voltage / 10;
+        zehntel = box->battery_voltage % 10;
 
         if ( !ganz ) {
             uart_puts_P( PSTR( "----" ) );
@@ -399,109 +408,318 @@ void list_complete( fireslave_t slaves[MAX_ID + 1], uint8_t wrongids ) {
         uart_puts_P( PSTR( ", " ) );
 
         // Show if armed or not
-        if ( slaves[i].slave_id ) {
-            uart_putc( slaves[i].sharpness );
-        }
-        else {
-            uart_puts_P( PSTR( "-" ) );
-        }
-
+        uart_putc( box->sharpness );
         uart_puts_P( PSTR( ", " ) );
 
-        // Show Temperature
-        if ( slaves[i].temperature != -128 ) {
-            fixedspace( slaves[i].temperature, 'd', 4 );
-        }
-        else {
-            slaves[i].slave_id ? uart_puts_P( PSTR( "n.a." ) ) : uart_puts_P( PSTR( "----" ) );
+        // Show Temperature (further sensors separated by a slash)
+        for ( uint8_t j = 0; j < TEMP_SENSORS; j++ ) {
+            if ( j ) {
+                uart_puts_P( PSTR( "/" ) );
+            }
+
+            if ( box->temperature[j] != -128 ) {
+                fixedspace( box->temperature[j], 'd', 4 );
+            }
+            else {
+                uart_puts_P( PSTR( "n.a." ) );
+            }
         }
 
         uart_puts_P( PSTR( ", " ) );
 
         // Show RSSI-values
-        if ( slaves[i].rssi ) {
-            if ( slaves[i].rssi < 100 ) {
+        if ( box->rssi ) {
+            if ( box->rssi < 100 ) {
                 uart_puts_P( PSTR( " " ) );
             }
 
-            if ( slaves[i].rssi < 10 ) {
+            if ( box->rssi < 10 ) {
                 uart_puts_P( PSTR( " " ) );
             }
 
             uart_puts_P( PSTR( "-" ) );
-            uart_shownum( slaves[i].rssi, 'd' );
+            uart_shownum( box->rssi, 'd' );
         }
         else {
             uart_puts_P( PSTR( "----" ) );
         }
 
-        if ( ( i % 3 ) == 2 ) {
+        if ( ( ( i % 3 ) == 2 ) || ( i == ( table->count - 1 ) ) ) {
             uart_puts_P( PSTR( "\n\r" ) );
         }
         else {
             uart_puts_P( PSTR( "\t" ) );
         }
+    }
+
+    if ( !table->count || ( i == ( table->count - 1 ) ) ) {
+        uart_puts_P( PSTR( "\n\rFehlerhafte/doppelte IDs: " ) );
+        uart_shownum( wrongids, 'd' );
+
+        if ( table->dropped ) {
+            uart_puts_P( PSTR( "\n\rNicht aufgenommen (Tabelle voll): " ) );
+            uart_shownum( table->dropped, 'd' );
+        }
+
+        uart_puts_P( PSTR( "\n\r" ) );
+    }
+}
+
 
-        i++;
+// Show number of boxes for one Slave-ID per call, only Slave-IDs with boxes are listed
+// (i = Slave-ID - 1, n = position within the list, i = MAX_ID ends the list)
+void list_array( const uint8_t *quantity, uint8_t i, uint8_t n ) {
+    if ( !n ) {
+        uart_puts_P( PSTR( "\n\rSlave-ID: Anzahl Boxen\n\r" ) );
     }
 
-    uart_puts_P( PSTR( "\n\rFehlerhafte/doppelte IDs: " ) );
-    uart_shownum( wrongids, 'd' );
-    uart_puts_P( PSTR( "\n\r" ) );
+    if ( i >= MAX_ID ) {
+        if ( !n ) {
+            uart_puts_P( PSTR( "---" ) );
+        }
+
+        uart_puts_P( PSTR( "\n\n\r" ) );
+        return;
+    }
+
+    if ( i < 9 ) {
+        uart_putc( '0' );
+    }
+
+    uart_shownum( i + 1, 'd' );
+    uart_puts_P( PSTR( ": " ) );
+    fixedspace( quantity[i], 'd', 3 );
+
+    if ( ( n % 3 ) == 2 ) {
+        uart_puts_P( PSTR( "\n\r" ) );
+    }
+    else {
+        uart_puts_P( PSTR( "\t \t \t \t" ) );
+    }
 }
 
+// List continuity and impedances of the channels of the boxes that replied (one box per call, i = position in the table)
+void list_continuity( const imptable_t *table, uint8_t i ) {
+    const impentry_t *entry = &table->box[i];
+    uint8_t           count = 0;
 
-// Show number of boxes for every Slave-ID
-void list_array( char *arr ) {
-    uint8_t i = 0;
-    uart_puts_P( PSTR( "\n\rSlave-ID: Anzahl Boxen\n\r" ) );
+    if ( !i ) {
+        uart_puts_P( PSTR( TERM_COL_YELLOW ) );
+        uart_puts_P( PSTR( "\n\n\rDurchgangsprüfung\n\r" ) );
+        uart_puts_P( PSTR( "=================\n\r" ) );
 
-    while ( i < MAX_ID ) {
-        if ( i < 9 ) {
+        uart_puts_P( PSTR( TERM_COL_WHITE ) );
+        uart_puts_P( PSTR( "\n\rUnique-ID: Kanäle (+ Durchgang, - offen), Anzahl mit Durchgang/gemeldete Kanäle\n\r" ) );
+        uart_puts_P( PSTR( "           Widerstand je Kanal in Ohm (ab Wert, Stufen zu " ) );
+        uart_shownum( IMPREPORT_STEP, 'd' );
+        uart_puts_P( PSTR( " Ohm, ?? noch unbekannt)\n\r" ) );
+    }
+
+    if ( i < table->count ) {
+        if ( entry->unique_id < 10 ) {
             uart_putc( '0' );
         }
 
-        uart_shownum( i + 1, 'd' );
+        uart_shownum( entry->unique_id, 'd' );
         uart_puts_P( PSTR( ": " ) );
 
-        switch ( arr[i] ) {
-            case 0: {
-                uart_puts_P( PSTR( "---" ) );
-                break;
+        // No reply to the last sweep
+        if ( !entry->channels ) {
+            uart_puts_P( PSTR( "---\n\r" ) );
+        }
+        else {
+            for ( uint8_t ch = 0; ch < entry->channels; ch++ ) {
+                if ( ch && !( ch & 7 ) ) {
+                    uart_putc( ' ' );
+                }
+
+                if ( entry->status[ch >> 3] & ( 1 << ( ch & 7 ) ) ) {
+                    uart_putc( '+' );
+                    count++;
+                }
+                else {
+                    uart_putc( '-' );
+                }
             }
 
-            default: {
-                fixedspace( arr[i], 'd', 3 );
-                break;
+            uart_puts_P( PSTR( ", " ) );
+            uart_shownum( count, 'd' );
+            uart_puts_P( PSTR( "/" ) );
+            uart_shownum( entry->channels, 'd' );
+            uart_puts_P( PSTR( "\n\r           " ) );
+
+            // 16 values per line, so boxes with 32 channels still fit into the terminal
+            for ( uint8_t ch = 0; ch < entry->channels; ch++ ) {
+                uint8_t q = impreport_value( entry, ch );
+
+                if ( ch && !( ch & 15 ) ) {
+                    uart_puts_P( PSTR( "\n\r           " ) );
+                }
+
+                if ( !( entry->status[ch >> 3] & ( 1 << ( ch & 7 ) ) ) ) {
+                    uart_puts_P( PSTR( " --" ) );
+                }
+                else if ( q == IMPREPORT_OPEN ) {
+                    uart_puts_P( PSTR( " ??" ) );
+                }
+                else {
+                    uart_putc( ' ' );
+
+                    if ( q * IMPREPORT_STEP < 10 ) {
+                        uart_putc( ' ' );
+                    }
+
+                    uart_shownum( q * IMPREPORT_STEP, 'd' );
+                }
             }
-        }
 
-        if ( ( i % 3 ) == 2 ) {
             uart_puts_P( PSTR( "\n\r" ) );
         }
-        else {
-            uart_puts_P( PSTR( "\t \t \t \t" ) );
+    }
+
+    if ( !table->count || ( i == ( table->count - 1 ) ) ) {
+        if ( !table->count ) {
+            uart_puts_P( PSTR( "Keine Antworten\n\r" ) );
         }
 
-        i++;
-    }
+        if ( table->dropped ) {
+            uart_puts_P( PSTR( "Nicht aufgenommen (Tabelle voll): " ) );
+            uart_shownum( table->dropped, 'd' );
+            uart_puts_P( PSTR( "\n\r" ) );
+        }
 
-    uart_puts_P( PSTR( "\n\n\r" ) );
+        uart_puts_P( PSTR( "\n\n\r" ) );
+    }
 }
+
+// Show one entry of the event log of a box
+void list_blackbox( uint8_t uid, const blackbox_entry_t *entry ) {
+    uint8_t state = entry->type & ~BLACKBOX_TYPE_MASK;
 
-// Calculate number of boxes with certain Slave-ID
-void evaluate_boxes( fireslave_t boxes[MAX_ID + 1], char *quantity ) {
-    uint8_t i, j, n;
+    if ( uid < 10 ) {
+        uart_putc( '0' );
+    }
+
+    uart_shownum( uid, 'd' );
+    uart_puts_P( PSTR( ": " ) );
+    fixedspace( entry->time[0] | ( (uint32_t) entry->time[1] << 8 ) | ( (uint32_t) entry->time[2] << 16 ), 'd', 8 );
+    uart_puts_P( PSTR( " ms  " ) );
 
-    for ( i = 1; i < MAX_ID+1; i++ ) {
-        n = 0;
+    switch ( entry->type & BLACKBOX_TYPE_MASK ) {
+        case BLACKBOX_BOOT: {
+            uart_puts_P( state ? PSTR( "Start (scharf)" ) : PSTR( "Start" ) );
+            break;
+        }
 
-        for ( j = 0; j < MAX_ID; j++ ) {
-            if ( boxes[j].slave_id == i ) {
-                n++;
+        case BLACKBOX_ARM: {
+            uart_puts_P( PSTR( "Scharf" ) );
+            break;
+        }
+
+        case BLACKBOX_DISARM: {
+            uart_puts_P( PSTR( "Entschärft" ) );
+            break;
+        }
+
+        case BLACKBOX_FIRE: {
+            uart_puts_P( PSTR( "Zündbefehl Kanal " ) );
+            uart_shownum( entry->channel, 'd' );
+
+            if ( entry->impedance == BLACKBOX_NA ) {
+                uart_puts_P( PSTR( ", Widerstand n.a." ) );
+            }
+            else if ( entry->impedance >= IMPREPORT_LIMIT ) {
+                uart_puts_P( PSTR( ", offen" ) );
+            }
+            else {
+                uart_puts_P( PSTR( ", " ) );
+                uart_shownum( entry->impedance, 'd' );
+                uart_puts_P( PSTR( " Ohm" ) );
+            }
+
+            switch ( state & ~BLACKBOX_LOCAL ) {
+                case BLACKBOX_SWITCHED: {
+                    uart_puts_P( PSTR( ", gezündet" ) );
+                    break;
+                }
+
+                case BLACKBOX_NOT_ARMED: {
+                    uart_puts_P( PSTR( ", nicht scharf" ) );
+                    break;
+                }
+
+                default: {
+                    uart_puts_P( PSTR( ", Kanal nicht vorhanden" ) );
+                    break;
+                }
+            }
+
+            if ( state & BLACKBOX_LOCAL ) {
+                uart_puts_P( PSTR( " (UART)" ) );
             }
+
+            break;
         }
 
-        quantity[i - 1] = n;
+        default: {
+            uart_puts_P( PSTR( "?" ) );
+            break;
+        }
+    }
+
+    uart_puts_P( PSTR( "\n\r" ) );
+}
+
+// Value in 0.1 % with decimal comma
+static void list_permille( uint16_t value ) {
+    uart_shownum( value / 10, 'd' );
+    uart_putc( ',' );
+    uart_putc( '0' + value % 10 );
+}
+
+// Show RAM usage and active shares of a box (own one or received via MEMREPORT)
+void list_memstat( uint8_t uid, const memstat_t *stat ) {
+    if ( uid < 10 ) {
+        uart_putc( '0' );
+    }
+
+    uart_shownum( uid, 'd' );
+    uart_puts_P( PSTR( ": Statische Daten " ) );
+    uart_shownum( stat->data, 'd' );
+    uart_puts_P( PSTR( " Byte, Stack max. " ) );
+    uart_shownum( stat->stack, 'd' );
+    uart_puts_P( PSTR( " Byte, frei min. " ) );
+    uart_shownum( stat->free, 'd' );
+    uart_puts_P( PSTR( " Byte, frei aktuell " ) );
+    uart_shownum( stat->free_now, 'd' );
+    uart_puts_P( PSTR( " Byte, aktiv " ) );
+    list_permille( stat->active );
+    uart_puts_P( PSTR( " % seit Start, " ) );
+    list_permille( stat->recent );
+    uart_puts_P( PSTR( " % in der letzten Minute\n\r" ) );
+}
+
+#if PROFILING
+// Show runs and durations of the profiled sections
+void list_prof( void ) {
+    static const char names[PROF_SECTIONS][11] PROGMEM = { "UART", "Senden", "Zünden", "Pulse", "Empfang", "LCD", "Sonstiges", "rfm_tx", "rfm_rx", "Abfragen" };
+    profstat_t        stat;
+
+    for ( uint8_t i = 0; i < PROF_SECTIONS; i++ ) {
+        prof_read( i, &stat );
+
+        uart_puts_P( names[i] );
+        uart_puts_P( PSTR( ":\t" ) );
+        fixedspace( stat.count, 'd', 7 );
+        uart_puts_P( PSTR( "x, gesamt " ) );
+        uart_shownum( stat.total / 1000, 'd' );
+        uart_puts_P( PSTR( " ms, min " ) );
+        uart_shownum( stat.min, 'd' );
+        uart_puts_P( PSTR( " us, max " ) );
+        uart_shownum( stat.max, 'd' );
+        uart_puts_P( PSTR( " us, Schnitt " ) );
+        uart_shownum( stat.count ? stat.total / stat.count : 0, 'd' );
+        uart_puts_P( PSTR( " us\n\r" ) );
     }
 }
+#endif
@@ -3,16 +3,46 @@
  *
  * Einstellungen zum Timer
  * Wird genutzt f�r UART- und RFM12-Timeouts, um Programmh�nger zu vermeiden
+ * Monotone Uhr: 10ms-Ticks von Timer 1, mit dem Zählerstand auf Mikrosekunden verfeinert, Deadlines für Timeouts
  */
 
 #ifndef TIMER_H_
 #define TIMER_H_
 
-#define TIMER_MEASURE_FLAG         1
-#define TIMER_TRANSMITCOUNTER_FLAG 2
+// Compare value for the 10ms tick (prescaler 8)
+#define TIMER1_TOP       ( F_CPU / 800 - 1 )
 
-void timer1_init( void );
-void timer1_on( void );
-void timer1_off( void );
-void timer1_reset( void );
+/*
+ * The clock counts the compare matches of Timer 1 (clock_tick() in the ISR) and adds the counter for the time
+ * within the tick. Timer 1 is never reset, so the clock only moves forward.
+ *
+ * Microseconds wrap after about 71 minutes: deadlines are compared by their difference and must not lie more than
+ * 35 minutes ahead. While interrupts are disabled (initialisation) clock_expired() counts a pending compare match
+ * itself, so waiting loops still time out.
+ */
+#define CLOCK_TICK_US    10000UL
+#define CLOCK_TICKS( T ) ( (uint32_t) ( T ) * CLOCK_TICK_US ) // 10ms ticks in microseconds
+#define CLOCK_MS( T )    ( (uint32_t) ( T ) * 1000UL )         // Milliseconds in microseconds
+
+void     timer1_init( void );
+void     timer1_on( void );
+void     timer1_off( void );
+void     clock_tick( void );
+uint8_t  clock_poll( void );
+uint32_t clock_ticks( void );
+uint32_t clock_us( void );
+uint32_t clock_ms( void );
+uint32_t clock_counts( void );
+uint32_t clock_counts_us( uint32_t counts );
+
+// Deadline us microseconds from now
+static inline uint32_t clock_deadline( uint32_t us ) {
+    return clock_us() + us;
+}
+
+// Deadline reached?
+static inline uint8_t clock_expired( uint32_t deadline ) {
+    clock_poll();
+    return (int32_t) ( clock_us() - deadline ) >= 0;
+}
 #endif
\ No newline at end of file
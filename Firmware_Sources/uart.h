@@ -45,7 +45,8 @@
 #define CTS_DDR         DDR( CTSPORT )
 #define CTS_PIN         PIN( CTSPORT )
 
-#define UART_TIMEOUTVAL (F_CPU)
+// Timeout for receiving and transmitting a char
+#define UART_TIMEOUT_US CLOCK_MS( 1000 )
 
 void block_uart_sending( void );
 void allow_uart_sending( void );
@@ -9,204 +9,435 @@
 
 
 
-// Search for 1-wire-device on bus
-uint8_t w1_reset( void ) {
-    uint8_t retval = 1;
+// Bus transactions are queued and run by the Timer 1 compare B interrupt. Timer 1 keeps running in CTC mode for the
+// 10ms tick, OCR1B is moved along from phase to phase of a time slot. Per bit there are three short interrupts
+// (start of slot, sampling, end of slot) instead of a busy delay over the whole slot.
+
+// Phases of a transaction
+#define W1_ST_RESET    0 // Pull bus low for reset pulse
+#define W1_ST_RELEASE  1 // End reset pulse
+#define W1_ST_PRESENCE 2 // Check presence pulse
+#define W1_ST_SLOT     3 // Start time slot
+#define W1_ST_SAMPLE   4 // Sample bus within time slot
+#define W1_ST_RECOVER  5 // End time slot
+
+static w1_request_t *volatile w1_queue[W1_QUEUE_LENGTH];
+static volatile uint8_t       w1_head = 0, w1_count = 0;
+
+// State of the running transaction
+static uint8_t w1_state, w1_pos, w1_writes, w1_bit, w1_byte, w1_out, w1_in;
+static uint8_t w1_search, w1_triplet, w1_id_bit, w1_bitnum, w1_last_zero, w1_crc;
+
+// Schedule next phase
+static void w1_schedule( uint16_t ticks ) {
+    uint16_t next = TCNT1 + ticks;
+
+    if ( next > OCR1A ) {
+        next -= OCR1A + 1;
+    }
 
-    W1_PORT &= ~( 1 << W1 );
-    W1_DDR  |= ( 1 << W1 );
-    _delay_us( 500 );
-    W1_DDR &= ~( 1 << W1 );
-    _delay_us( 66 );
+    OCR1B = next;
+}
+
+// Byte number pos of a transaction: ROM command, ROM-ID, function command, data to write, 0xFF for reading
+static uint8_t w1_stream( w1_request_t *req, uint8_t pos ) {
+    if ( req->command == W1_NO_RESET ) {
+        return ( pos < req->write ) ? req->data[pos] : 0xFF;
+    }
+
+    if ( !pos ) {
+        return ( req->command == SEARCH_ROM ) ? SEARCH_ROM : ( req->id ? MATCH_ROM : SKIP_ROM );
+    }
+
+    if ( req->id && ( pos < 9 ) ) {
+        return req->id[pos - 1];
+    }
+
+    pos -= req->id ? 9 : 1;
 
-    if ( !( W1_PIN & ( 1 << W1 ) ) ) {
-        retval = 0;
+    if ( !pos ) {
+        return req->command;
     }
 
-    _delay_us( 434 );
-    return retval;
+    return ( --pos < req->write ) ? req->data[pos] : 0xFF;
 }
 
-// IO-Access
-uint8_t w1_bit_io( uint8_t val ) {
-    W1_DDR |= ( 1 << W1 );
-    _delay_us( 3 );
+// Start the request at the head of the queue
+static void w1_start_next( void ) {
+    w1_request_t *req;
 
-    if ( val ) {
-        W1_DDR &= ~( 1 << W1 );
+    if ( !w1_count ) {
+        TIMSK1 &= ~( 1 << OCIE1B );
+        return;
     }
 
-    _delay_us( 11 );
+    req       = w1_queue[w1_head];
+    w1_pos    = 0;
+    w1_bit    = 0;
+    w1_search = 0;
+
+    switch ( req->command ) {
+        case W1_RESET_ONLY: {
+            w1_writes = 0;
+            w1_state  = W1_ST_RESET;
+            break;
+        }
+
+        case W1_NO_RESET: {
+            w1_writes = req->write;
+            w1_state  = W1_ST_SLOT;
+            break;
+        }
+
+        case SEARCH_ROM: {
+            w1_writes = 1;
+            w1_state  = W1_ST_RESET;
+            break;
+        }
 
-    if ( !( W1_PIN & ( 1 << W1 ) ) ) {
-        val = 0;
+        default: {
+            w1_writes = ( req->id ? 10 : 2 ) + req->write;
+            w1_state  = W1_ST_RESET;
+            break;
+        }
     }
 
-    _delay_us( 46 );
+    w1_byte = w1_stream( req, 0 );
+    w1_out  = w1_byte & 1;
+
+    w1_schedule( W1_TICKS( 10 ) );
+    TIFR1   = ( 1 << OCF1B );
+    TIMSK1 |= ( 1 << OCIE1B );
+}
+
+// Finish running request and start the next one
+static void w1_finish( uint8_t result ) {
+    w1_request_t *req = w1_queue[w1_head];
+
     W1_DDR &= ~( 1 << W1 );
-    _delay_us( 2 );
-    return val;
+
+    req->result = result;
+    req->busy   = 0;
+    req->done   = 1;
+
+    if ( req->event != EVENT_NONE ) {
+        event_post( req->event );
+    }
+
+    w1_head = ( w1_head + 1 ) % W1_QUEUE_LENGTH;
+    w1_count--;
+    w1_start_next();
 }
 
-// Write a byte
-uint8_t w1_byte_wr( uint8_t byte ) {
-    uint8_t j;
+// Evaluate a finished time slot of the ROM search (read bit, read complement, write direction)
+static uint8_t w1_search_bit( w1_request_t *req ) {
+    uint8_t *id = req->id + ( ( 64 - w1_bitnum ) >> 3 );
+
+    switch ( w1_triplet ) {
+        case 0: {
+            w1_id_bit  = w1_in;
+            w1_triplet = 1;
+            w1_out     = 1;
+            break;
+        }
+
+        case 1: {
+            // Data error if bit AND complement are 1
+            if ( w1_id_bit && w1_in ) {
+                return DATA_ERR;
+            }
+
+            // Discrepancy if bit AND complement are 0 (directions as in the former blocking search)
+            if ( !w1_id_bit && !w1_in ) {
+                if ( ( req->diff > w1_bitnum ) || ( ( *id & 1 ) && ( req->diff != w1_bitnum ) ) ) {
+                    w1_id_bit    = 1;
+                    w1_last_zero = w1_bitnum;
+                }
+            }
+
+            w1_triplet = 2;
+            w1_out     = w1_id_bit;
+            break;
+        }
+
+        default: {
+            *id >>= 1;
+
+            if ( w1_id_bit ) {
+                *id |= 0x80;
+            }
+
+            w1_bitnum--;
 
-    for ( uint8_t i = 8; i; i-- ) {
-        j      = w1_bit_io( byte & 1 );
-        byte >>= 1;
+            if ( !( w1_bitnum & 7 ) ) {
+                w1_crc = crc8( w1_crc, *id );
+            }
 
-        if ( j ) {
-            byte |= 0x80;
+            w1_triplet = 0;
+            w1_out     = 1;
+            break;
         }
     }
 
-    return byte;
+    return 0;
 }
 
-// Read a byte
-uint8_t w1_byte_rd( void ) {
-    return w1_byte_wr( 0xFF );
-}
+// Evaluate a finished time slot, returns 1 if the transaction is complete
+static uint8_t w1_next_bit( w1_request_t *req ) {
+    if ( w1_search ) {
+        if ( w1_search_bit( req ) ) {
+            w1_finish( DATA_ERR );
+            return 1;
+        }
 
-// Send a command to a single or to all devices
-void w1_command( uint8_t command, uint8_t *id ) {
-    uint8_t i;
+        if ( !w1_bitnum ) {
+            req->diff = w1_last_zero;
+            w1_finish( w1_crc ? DATA_ERR : 0 );
+            return 1;
+        }
 
-    w1_reset();
+        return 0;
+    }
 
-    if ( id ) {
-        w1_byte_wr( MATCH_ROM ); // to a single device
-        i = 8;
+    // Bits are sent LSB first, read bits are shifted in from the top
+    w1_byte >>= 1;
 
-        do {
-            w1_byte_wr( *id++ );
-        } while ( --i );
+    if ( w1_in ) {
+        w1_byte |= 0x80;
+    }
+
+    if ( ++w1_bit < 8 ) {
+        w1_out = w1_byte & 1;
+        return 0;
+    }
+
+    if ( w1_pos >= w1_writes ) {
+        req->data[w1_pos - w1_writes] = w1_byte;
     }
-    else {
-        w1_byte_wr( SKIP_ROM ); // to all devices
 
+    w1_bit = 0;
+    w1_pos++;
+
+    // SEARCH_ROM has been sent, continue with 64 bit triplets
+    if ( req->command == SEARCH_ROM ) {
+        w1_search    = 1;
+        w1_triplet   = 0;
+        w1_bitnum    = 64;
+        w1_last_zero = LAST_DEVICE;
+        w1_crc       = 0;
+        w1_out       = 1;
+        return 0;
     }
 
-    w1_byte_wr( command );
+    if ( w1_pos >= w1_writes + req->read ) {
+        w1_finish( 0 );
+        return 1;
+    }
+
+    w1_byte = w1_stream( req, w1_pos );
+    w1_out  = w1_byte & 1;
+    return 0;
 }
 
-// Perform rom search (detect all available sensors)
-uint8_t w1_rom_search( uint8_t last_discrepancy, uint8_t *id ) {
-    uint8_t id_bit_number, j, last_zero = LAST_DEVICE;
-    uint8_t id_bit, cmp_id_bit, crcw = 1, tries = 10;
+// Next phase of the running transaction
+static void w1_service( void ) {
+    w1_request_t *req = w1_queue[w1_head];
+    uint16_t      start;
 
-    while ( crcw && tries-- ) {
-        crcw = 0;
+    if ( !w1_count ) {
+        TIMSK1 &= ~( 1 << OCIE1B );
+        return;
+    }
 
-        if ( w1_reset() ) {
-            return PRESENCE_ERR;  // error, no device found
+    switch ( w1_state ) {
+        case W1_ST_RESET: {
+            W1_DDR  |= ( 1 << W1 );
+            w1_schedule( W1_TICKS( 500 ) );
+            w1_state = W1_ST_RELEASE;
+            break;
+        }
 
+        case W1_ST_RELEASE: {
+            W1_DDR  &= ~( 1 << W1 );
+            w1_schedule( W1_TICKS( 66 ) );
+            w1_state = W1_ST_PRESENCE;
+            break;
         }
 
-        w1_byte_wr( SEARCH_ROM ); // issue ROM search command
+        case W1_ST_PRESENCE: {
+            if ( W1_PIN & ( 1 << W1 ) ) {
+                w1_finish( PRESENCE_ERR );
+                break;
+            }
+
+            w1_schedule( W1_TICKS( 434 ) );
+            w1_state = ( req->command == W1_RESET_ONLY ) ? W1_ST_RECOVER : W1_ST_SLOT;
+            break;
+        }
 
-        last_zero = LAST_DEVICE;  // set last position where zero was written to 0
+        // Pull bus low for 3us, release it for writing a 1 (and reading), sample 12us after the start of the slot
+        case W1_ST_SLOT: {
+            start = TCNT1;
 
-        id_bit_number = 64;       // 8 bytes (64 bits)
+            // The 10ms tick (compare A) would delay sampling, start the slot after it
+            if ( ( OCR1A - start ) < W1_TICKS( 70 ) ) {
+                w1_schedule( W1_TICKS( 70 ) );
+                break;
+            }
 
-        while ( id_bit_number ) {
-            for ( j = 8; j; j-- ) {          // 8 bits can be stored in 1 byte
-                id_bit     = w1_bit_io( 1 ); // read bit
-                cmp_id_bit = w1_bit_io( 1 ); // read complement bit
+            W1_DDR |= ( 1 << W1 );
+            _delay_us( 3 );
 
-                // data error if bit AND complement are 1
-                if ( id_bit && cmp_id_bit ) {
-                    return DATA_ERR;
-                }
+            if ( w1_out ) {
+                W1_DDR &= ~( 1 << W1 );
+            }
 
-                /* Discrepancy if bit AND complement are 0
-                 * Go the '1'-direction if last_discrepancy is bigger than id_bit_number.
-                 * Go the '0'-direction if last_discrepancy is equal to id_bit_number.
-                 * Go the same direction as last time if last_discrepancy is smaller than id_bit_number */
-                if ( !id_bit && !cmp_id_bit ) {
-                    if ( ( last_discrepancy > id_bit_number ) || ( ( *id & 1 ) && ( last_discrepancy != id_bit_number ) ) ) {
-                        id_bit    = 1;             // now 1
-                        last_zero = id_bit_number; // next pass 0
-                    }
-                }
+            start += W1_TICKS( 12 );
 
-                w1_bit_io( id_bit ); // write bit
-                *id >>= 1;
+            if ( start > OCR1A ) {
+                start -= OCR1A + 1;
+            }
 
-                if ( id_bit ) {
-                    *id |= 0x80;     // store bit
+            OCR1B    = start;
+            w1_state = W1_ST_SAMPLE;
+            break;
+        }
 
-                }
+        // The slot lasts at least 60us (12us + 48us) before the bus is released
+        case W1_ST_SAMPLE: {
+            w1_in    = ( W1_PIN & ( 1 << W1 ) ) && 1;
+            w1_schedule( W1_TICKS( 48 ) );
+            w1_state = W1_ST_RECOVER;
+            break;
+        }
 
-                id_bit_number--;
+        default: {
+            W1_DDR &= ~( 1 << W1 );
+
+            if ( req->command == W1_RESET_ONLY ) {
+                w1_finish( 0 );
+                break;
+            }
+
+            if ( !w1_next_bit( req ) ) {
+                w1_schedule( W1_TICKS( 5 ) );
+                w1_state = W1_ST_SLOT;
             }
 
-            crcw = crc8( crcw, *id );
-            id++; // go to next byte
+            break;
         }
     }
-
-    return last_zero; // to continue search
 }
 
-// Collect sensor IDs
-uint8_t w1_get_sensor_ids( uint8_t id_field[][8] ) {
-    uint8_t devnum, diff, id[9];
+// Queue request, returns 0 if the queue is full or the request is already queued
+uint8_t w1_request( w1_request_t *req ) {
+    uint8_t temp_sreg = SREG, queued = 0;
 
-    devnum = 0;
-    diff   = SEARCH_FIRST;
+    cli();
 
-    while ( diff != LAST_DEVICE ) {
-        diff = w1_rom_search( diff, id );
+    if ( !req->busy && ( w1_count < W1_QUEUE_LENGTH ) ) {
+        req->busy = 1;
+        req->done = 0;
+        w1_queue[( w1_head + w1_count ) % W1_QUEUE_LENGTH] = req;
+        w1_count++;
+        queued = 1;
 
-        if ( diff == PRESENCE_ERR ) {
-            return 0;
+        if ( w1_count == 1 ) {
+            w1_start_next();
         }
+    }
 
-        for ( uint8_t i = 0; i < 8; i++ ) {
-            id_field[devnum][i] = id[i];
+    SREG = temp_sreg;
+    return queued;
+}
+
+// Wait for a queued request, returns its result (0, PRESENCE_ERR or DATA_ERR). If it isn't done after W1_TIMEOUT_US,
+// it is finished with DATA_ERR together with the requests queued before it, so the bus is released again
+uint8_t w1_wait( w1_request_t *req ) {
+    uint32_t deadline = clock_deadline( W1_TIMEOUT_US );
+
+    while ( req->busy ) {
+        // Interrupts disabled (e.g. during initialisation): serve the bus by polling
+        if ( !( SREG & ( 1 << SREG_I ) ) && ( TIFR1 & ( 1 << OCF1B ) ) ) {
+            TIFR1 = ( 1 << OCF1B );
+            w1_service();
         }
 
-        devnum++;
+        if ( clock_expired( deadline ) ) {
+            uint8_t temp_sreg = SREG;
+
+            cli();
+
+            while ( req->busy ) {
+                w1_finish( DATA_ERR );
+            }
+
+            SREG = temp_sreg;
+        }
     }
 
-    return devnum;
+    return req->result;
+}
+
+// No request queued or running
+uint8_t w1_idle( void ) {
+    return !w1_count;
+}
+
+// Blocking transaction, returns 0, PRESENCE_ERR or DATA_ERR
+uint8_t w1_transfer( uint8_t command, uint8_t *id, uint8_t *data, uint8_t write, uint8_t read ) {
+    w1_request_t req = { command, id, data, write, read, EVENT_NONE, 0, 0, 0, 0 };
+
+    while ( !w1_request( &req ) );
+
+    return w1_wait( &req );
 }
 
-// Configure temperature parameters
-void w1_temp_conf( int8_t th, int8_t tl, uint8_t res ) {
-    res  -= 9;
-    res <<= 5;
-    res  &= 0x7F;
-    res  |= 0x1F;
-
-    w1_command( WRITE, NULL );
-    w1_byte_wr( th );
-    w1_byte_wr( tl );
-    w1_byte_wr( res );
+// Perform rom search (detect all available sensors), passes with CRC errors are repeated
+uint8_t w1_rom_search( uint8_t last_discrepancy, uint8_t *id ) {
+    w1_request_t req = { SEARCH_ROM, id, NULL, 0, 0, EVENT_NONE, 0, 0, 0, 0 };
+
+    for ( uint8_t tries = 10; tries; tries-- ) {
+        req.diff = last_discrepancy;
+
+        while ( !w1_request( &req ) );
+
+        w1_wait( &req );
+
+        if ( req.result != DATA_ERR ) {
+            break;
+        }
+    }
+
+    if ( req.result ) {
+        return req.result;
+    }
+
+    return req.diff; // to continue search
 }
 
-// Read temperature in generic format
-uint16_t w1_read_temp( uint8_t *id ) {
-    uint8_t scratchpad[10], value, crcw = 1;
+// Collect sensor IDs (at most max), returns the number of IDs found
+uint8_t w1_get_sensor_ids( uint8_t id_field[][8], uint8_t max ) {
+    uint8_t devnum, diff, id[9];
+
+    devnum = 0;
+    diff   = SEARCH_FIRST;
 
-    while ( crcw ) {
-        crcw = 0;
-        w1_command( READ, id );
+    while ( ( diff != LAST_DEVICE ) && ( devnum < max ) ) {
+        diff = w1_rom_search( diff, id );
 
-        for ( uint8_t i = 0; i < 9; i++ ) {
-            value         = w1_byte_rd();
-            scratchpad[i] = value;
-            crcw          = crc8( crcw, value );
+        if ( diff == PRESENCE_ERR ) {
+            return 0;
         }
 
-        if ( scratchpad[7] == 0xFF ) {
-            return DEVICE_REMOVED;
+        for ( uint8_t i = 0; i < 8; i++ ) {
+            id_field[devnum][i] = id[i];
         }
+
+        devnum++;
     }
 
-    return scratchpad[0] + ( scratchpad[1] << 8 );
+    return devnum;
 }
 
 // Transform generic format into deci-degrees
@@ -227,32 +458,6 @@ int16_t w1_tempread_to_celsius( uint16_t temp, uint8_t digit ) {
     return celsius;
 }
 
-// Complete temperature measurement cycle
-int16_t w1_tempmeas( uint8_t byten ) {
-    uint8_t  diff, id[9];
-    uint16_t temp_hex;
-    int16_t  temp;
-
-    w1_command( CONVERT_T, NULL );
-
-    while ( !w1_bit_io( 1 ) );
-
-    diff = SEARCH_FIRST;
-    diff = w1_rom_search( diff, id );
-    w1_command( READ, id );
-    temp_hex  = w1_byte_rd();
-    temp_hex += ( w1_byte_rd() ) << 8;
-
-    if ( byten ) {
-        temp = w1_tempread_to_celsius( temp_hex, 1 );
-    }
-    else {
-        temp = w1_tempread_to_celsius( temp_hex, 0 );
-    }
-
-    return temp;
-}
-
 // Temperature to string conversion
 void w1_temp_to_array( int32_t tempmalzehn, char *tempfield, uint8_t signdigit ) {
     // 0 < signdigit < 3
@@ -293,4 +498,8 @@ void w1_temp_to_array( int32_t tempmalzehn, char *tempfield, uint8_t signdigit )
     else {
         tempfield[neededlength + fieldcntr] = '\0';
     }
-}
\ No newline at end of file
+}
+
+ISR( TIMER1_COMPB_vect ) {
+    w1_service();
+}
@@ -35,53 +35,169 @@ void adc_init( void ) {
 
     nosense  = ADCW;
     nosense += 3;
+
+    // Results are collected by the ADC interrupt from now on
+    ADCSRA |= 1 << ADIE;
+}
+
+// ------------------------------------------------------------------------------------------------------------------------
+
+// Conversion service: requests are queued and served by the ADC interrupt, the first conversion after switching
+// the channel is discarded, then 4^extra_bits samples are summed up and decimated to 10 + extra_bits bits
+static adc_request_t *volatile adc_queue[ADC_QUEUE_LENGTH];
+static volatile uint8_t        adc_head = 0, adc_count = 0, adc_samples = 0, adc_skip = 0;
+static volatile uint16_t       adc_sum  = 0;
+
+// Start conversions for the request at the head of the queue
+static void adc_start_next( void ) {
+    adc_request_t *req;
+
+    if ( !adc_count ) {
+        return;
+    }
+
+    req = adc_queue[adc_head];
+
+    ADMUX      &= ~( 0x07 );
+    ADMUX      |= req->channel;
+    adc_sum     = 0;
+    adc_samples = 1 << ( 2 * req->extra_bits );
+    adc_skip    = 1;
+
+    ADCSRA |= 1 << ADSC;
 }
 
-static uint16_t adc_read( const uint8_t channel ) {
-    uint16_t result = 0;
+// Handle a finished conversion
+static void adc_service( void ) {
+    adc_request_t *req;
+
+    // Conversion not requested by anybody (e.g. started by entering sleep mode)
+    if ( !adc_count ) {
+        return;
+    }
 
-    ADMUX &= ~( 0x07 );
-    ADMUX |= channel;
+    req = adc_queue[adc_head];
+
+    if ( adc_skip ) {
+        adc_skip = 0;
+    }
+    else {
+        adc_sum += ADCW;
+        adc_samples--;
+    }
 
-    // 9 measurements, discarding the first, summing up the rest
-    for ( uint8_t i = 9; i; i-- ) {
+    if ( adc_samples ) {
         ADCSRA |= 1 << ADSC;
+        return;
+    }
 
-        while ( ADCSRA & ( 1 << ADSC ) );
+    req->result = adc_sum >> req->extra_bits;
+    req->busy   = 0;
+    req->done   = 1;
 
-        result += ADCW;
+    if ( req->event != EVENT_NONE ) {
+        event_post( req->event );
+    }
+
+    adc_head = ( adc_head + 1 ) % ADC_QUEUE_LENGTH;
+    adc_count--;
+    adc_start_next();
+}
 
-        // Discard first measurement
-        if ( i == 9 ) {
-            result = 0;
+// Queue request, returns 0 if the queue is full, the request is already queued or the ADC is off
+uint8_t adc_request( adc_request_t *req ) {
+    uint8_t temp_sreg = SREG, queued = 0;
+
+    cli();
+
+    if ( ( ADCSRA & ( 1 << ADEN ) ) && !req->busy && ( adc_count < ADC_QUEUE_LENGTH ) ) {
+        req->busy = 1;
+        req->done = 0;
+        adc_queue[( adc_head + adc_count ) % ADC_QUEUE_LENGTH] = req;
+        adc_count++;
+        queued = 1;
+
+        if ( adc_count == 1 ) {
+            adc_start_next();
         }
     }
-    result >>= 3;
 
-    return result;
+    SREG = temp_sreg;
+    return queued;
+}
+
+#if ADC_NOISE_SLEEP
+// Noise reduction mode stops Timer 1 and the UART, only sleep if neither of them has work to do
+static uint8_t adc_may_sleep( void ) {
+    return w1_idle() && !( MOSSWITCHPORT & ( 1 << MOSSWITCH ) )
+           && ( UCSR0A & ( 1 << UDRE0 ) ) && !( UCSR0A & ( 1 << RXC0 ) );
+}
+#endif
+
+// Wait for result of a queued request
+void adc_wait( adc_request_t *req ) {
+    while ( req->busy ) {
+        // Interrupts disabled (e.g. during initialisation): serve the ADC by polling
+        if ( !( SREG & ( 1 << SREG_I ) ) ) {
+            if ( ADCSRA & ( 1 << ADIF ) ) {
+                ADCSRA |= 1 << ADIF;
+                adc_service();
+            }
+        }
+        else {
+            #if ADC_NOISE_SLEEP
+                // The ADC interrupt wakes the controller again
+                cli();
+
+                if ( req->busy && adc_may_sleep() ) {
+                    set_sleep_mode( SLEEP_MODE_ADC );
+                    sleep_enable();
+                    sei();
+                    sleep_cpu();
+                    sleep_disable();
+                }
+
+                sei();
+            #endif
+        }
+    }
+}
+
+// Blocking conversion
+uint16_t adc_sample( const uint8_t channel, const uint8_t extra_bits ) {
+    adc_request_t req = { channel, extra_bits, EVENT_NONE, 0, 0, 0 };
+
+    if ( !adc_request( &req ) ) {
+        return 0;
+    }
+
+    adc_wait( &req );
+    return req.result;
+}
+
+ISR( ADC_vect ) {
+    adc_service();
 }
 
 // Calculation of battery voltage
 uint8_t bat_calc( const uint8_t channel ) {
 
     uint8_t  result;
-    uint16_t voltage_raw = adc_read( channel );
+    uint32_t voltage_raw = adc_sample( channel, ADC_EXTRA_BITS );
 
-    // voltage_raw * 11 / 64 = voltage_in
-    result = ( 11 * voltage_raw + 32 ) >> 6;
+    // voltage_raw (10 bit) * 11 / 64 = voltage_in
+    result = ( 11 * voltage_raw + ( 32 << ADC_EXTRA_BITS ) ) >> ( 6 + ADC_EXTRA_BITS );
 
     return result;
 }
 
-uint8_t imp_calc( const uint8_t channel ) {
-    uint16_t voltage_raw;
-    uint8_t  result;
-
-    voltage_raw = adc_read( channel );
+// Calculation of channel impedance from a conversion with ADC_EXTRA_BITS
+uint8_t imp_calc( const uint16_t voltage_raw ) {
+    uint8_t result;
 
     // With 1.1V-reference:
-    // 25/512 * voltage_raw = R
-    result = ( 25 * voltage_raw + 256 ) >> 9;
+    // 25/512 * voltage_raw (10 bit) = R
+    result = ( 25UL * voltage_raw + ( 256 << ADC_EXTRA_BITS ) ) >> ( 9 + ADC_EXTRA_BITS );
 
     // Check
     if ( !result ) {
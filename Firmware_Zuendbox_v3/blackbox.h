@@ -0,0 +1,84 @@
+/*
+ * blackbox.h
+ * Ereignisprotokoll (Zündbefehle, Scharf/Entschärft) als Ringpuffer im EEPROM
+ */
+
+#ifndef BLACKBOX_H_
+#define BLACKBOX_H_
+
+/*
+ * Entry layout (8 bytes):
+ *
+ * [0]       Sequence number, the entry without a successor (next sequence number) is the newest one
+ * [1]       Type (upper nibble) and state (lower nibble)
+ * [2 ... 4] Time in ms since start (LSB first, wraps after 4.6 hours)
+ * [5]       Channel (FIRE)
+ * [6]       Impedance of the channel before the pulse in Ohms (FIRE, BLACKBOX_NA if unknown)
+ * [7]       CRC8 of bytes 0 ... 6 (seed BLACKBOX_CRC_SEED), entries with a wrong CRC (never or partially written)
+ *           are skipped
+ *
+ * New entries are kept in RAM and written one by one from the main loop as long as no channel is firing and the
+ * EEPROM queue has room, so the fire path never waits for the EEPROM.
+ */
+
+// Ring of entries behind the settings (see settings.h)
+#define BLACKBOX_START       ( SETTINGS_START + SETTINGS_SLOTS * SETTINGS_SLOT_SIZE )
+#define BLACKBOX_ENTRY_SIZE  8
+#define BLACKBOX_ENTRIES     32
+
+// Erased (0xFF) and cleared (0x00) entries never have a valid CRC with this seed
+#define BLACKBOX_CRC_SEED    0x42
+
+// Entries waiting in RAM to be written, further entries get lost
+#define BLACKBOX_BUFFER      4
+
+// Types
+#define BLACKBOX_BOOT        0x10 // Device started
+#define BLACKBOX_ARM         0x20 // Key switch armed
+#define BLACKBOX_DISARM      0x30 // Key switch disarmed
+#define BLACKBOX_FIRE        0x40 // Ignition command for this box, time of receipt
+
+// State of BOOT: 1 = armed at start
+
+// States of FIRE
+#define BLACKBOX_SWITCHED    0    // Channel has been switched
+#define BLACKBOX_NOT_ARMED   1    // Box was not armed
+#define BLACKBOX_NO_CHANNEL  2    // Channel does not exist on this box
+#define BLACKBOX_LOCAL       8    // Command came via UART (flag)
+
+#define BLACKBOX_TYPE_MASK   0xF0
+#define BLACKBOX_NA          0xFF
+
+// Radio dump: LOGDATA message = type, Unique-ID, number of the first entry, BLACKBOX_PER_MESSAGE entries
+#define BLACKBOX_PER_MESSAGE 3
+#define BLACKBOX_MESSAGE     3    // Position of the first entry
+
+// Ticks (10ms) between two LOGDATA messages, gives the receiver time to show the entries
+#define BLACKBOX_GAP         10
+
+#if ( BLACKBOX_START + BLACKBOX_ENTRIES * BLACKBOX_ENTRY_SIZE ) > ( E2END + 1 )
+    #error "Blackbox does not fit into the EEPROM!"
+#endif
+
+#if LOGDATA_LENGTH > MAX_COM_ARRAYSIZE
+    #error "LOGDATA does not fit into the communication array!"
+#endif
+
+typedef struct {
+    uint8_t seq;
+    uint8_t type;
+    uint8_t time[3];
+    uint8_t channel;
+    uint8_t impedance;
+    uint8_t crc;
+} blackbox_entry_t;
+
+void     blackbox_init( void );
+uint32_t blackbox_time( void );
+void     blackbox_add( uint8_t type, uint32_t time, uint8_t channel, uint8_t impedance );
+void     blackbox_flush( void );
+uint8_t  blackbox_ready( void );
+uint8_t  blackbox_valid( const blackbox_entry_t *entry );
+uint8_t  blackbox_read( uint8_t n, blackbox_entry_t *entry );
+uint8_t  blackbox_to_frame( char *frame, uint8_t uid, uint8_t n );
+#endif
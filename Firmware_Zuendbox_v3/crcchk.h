@@ -9,6 +9,12 @@
 #define CRC16_SEED 0x1D0F
 #define CRC8_SEED  0
 
+// Implementation of crc8() and crc16(): 0 = bit by bit (no table), 1 = nibble tables (48 bytes flash),
+// 2 = byte tables (768 bytes flash)
+#ifndef CRC_TABLES
+    #define CRC_TABLES 1
+#endif
+
 uint16_t crc16( uint16_t crc, uint8_t data );
 uint8_t crc8( uint8_t crc, uint8_t data );
 uint16_t crcwert( char *feld, uint8_t startindex, uint8_t laenge, uint16_t crc, uint8_t crctype );
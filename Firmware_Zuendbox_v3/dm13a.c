@@ -59,35 +59,33 @@ void dm_disable( void ) {
     EN_PORT |= ( 1 << EN );
 }
 
-// Transfer 16 bit pattern to outputs
-void dm_shiftout( uint32_t scheme ) {
+// Transfer channel pattern to outputs, highest channel first
+void dm_shiftout( chanset_t scheme ) {
     DAI_PORT &= ~( 1 << DAI );
     DCK_PORT &= ~( 1 << DCK );
     LAT_PORT &= ~( 1 << LAT );
-    uint32_t mask = 0x000000FF << (DM_CHANNELS - 8);
 
-    #if HARDWARE_SPI_DM
+    for ( uint8_t i = DM_CHANNELS / 8; i; i-- ) {
+        uint8_t pattern = chanset_byte( scheme, i - 1 );
+
+        #if HARDWARE_SPI_DM
+            SPDR = pattern;
 
-        for(uint8_t i = DM_CHANNELS / 8; i; i--) {
-            SPDR = (scheme & mask) >> (DM_CHANNELS - 8);
-            scheme <<= 8;
             while ( !( SPSR & ( 1 << SPIF ) ) );
-        }
 
-    #else
-        mask = 1UL << ( DM_CHANNELS - 1 );
+        #else
+            for ( uint8_t mask = 0x80; mask; mask >>= 1 ) {
+                if ( pattern & mask ) {
+                    DAI_PORT |= 1 << DAI;
+                }
 
-        for ( uint8_t i = DM_CHANNELS; i; i-- ) {
-            if ( scheme & mask ) {
-                DAI_PORT |= 1 << DAI;
+                DCK_PIN   = ( 1 << DCK ); // Pin high after toggling
+                DCK_PIN   = ( 1 << DCK ); // Pin low after toggling
+                DAI_PORT &= ~( 1 << DAI );
             }
+        #endif
+    }
 
-            DCK_PIN   = ( 1 << DCK ); // Pin high after toggling
-            DCK_PIN   = ( 1 << DCK ); // Pin low after toggling
-            DAI_PORT &= ~( 1 << DAI );
-            mask    >>= 1;
-        }
-    #endif
     LAT_PIN = ( 1 << LAT ); // Pin high after toggling
     LAT_PIN = ( 1 << LAT ); // Pin low after toggling
 }
@@ -29,7 +29,7 @@
 void dm_init( void );
 void dm_enable( void );
 void dm_disable( void );
-void dm_shiftout( uint32_t scheme );
+void dm_shiftout( chanset_t scheme );
 
 // Generation of names
 #define DAI_PORT            PORT( DAI_P )
@@ -7,6 +7,15 @@
 #ifndef EEPROM_H_
 #define EEPROM_H_
 
+// Number of bytes the write queue can hold (power of 2, one entry stays unused), each write takes about 3.4ms
+#define EE_QUEUE_SIZE 32
+
+#if ( EE_QUEUE_SIZE & ( EE_QUEUE_SIZE - 1 ) )
+    #error "EE_QUEUE_SIZE has to be a power of 2!"
+#endif
+
 uint8_t eeread( uint16_t address );
-void eewrite( uint8_t data, uint16_t address );
+void    eewrite( uint8_t data, uint16_t address );
+uint8_t eeroom( void );
+void    eeflush( void );
 #endif
\ No newline at end of file
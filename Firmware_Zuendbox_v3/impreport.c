@@ -0,0 +1,200 @@
+/*
+ * impreport.c
+ *
+ * Compact impedance reports (see impreport.h for the frame layout)
+ */
+
+#include "global.h"
+
+// Quantize impedance (Ohms), open channels get IMPREPORT_OPEN
+uint8_t impreport_quantize( const uint8_t impedance ) {
+    if ( impedance >= IMPREPORT_LIMIT ) {
+        return IMPREPORT_OPEN;
+    }
+
+    return impedance / IMPREPORT_STEP;
+}
+
+// Build report from the impedances of this box, only values that changed since the last report are included.
+// Returns the message length without the byte for the number of repetitions.
+uint8_t impreport_encode( char *frame, const uint8_t uid, const uint8_t *impedances, impreport_t *last ) {
+    uint8_t full = !last->count, pos = 3 + 2 * IMPREPORT_BYTES( IMPREPORT_CHANNELS ), nibbles = 0;
+
+    frame[0] = IMPREPORT;
+    frame[1] = uid;
+    frame[2] = IMPREPORT_CHANNELS | ( full ? IMPREPORT_FULL : 0 );
+
+    for ( uint8_t i = 3; i < pos; i++ ) {
+        frame[i] = 0;
+    }
+
+    for ( uint8_t ch = 0; ch < IMPREPORT_CHANNELS; ch++ ) {
+        uint8_t q    = impreport_quantize( impedances[ch] );
+        uint8_t prev = ( ch & 1 ) ? ( last->values[ch >> 1] >> 4 ) : ( last->values[ch >> 1] & 0x0F );
+
+        if ( q != IMPREPORT_OPEN ) {
+            frame[3 + ( ch >> 3 )] |= 1 << ( ch & 7 );
+        }
+
+        if ( !full && ( q == prev ) ) {
+            continue;
+        }
+
+        // Mark channel as changed and append its value
+        frame[3 + IMPREPORT_BYTES( IMPREPORT_CHANNELS ) + ( ch >> 3 )] |= 1 << ( ch & 7 );
+
+        if ( nibbles & 1 ) {
+            frame[pos++] |= q << 4;
+        }
+        else {
+            frame[pos] = q;
+        }
+
+        nibbles++;
+
+        // Remember what has been sent
+        if ( ch & 1 ) {
+            last->values[ch >> 1] = ( last->values[ch >> 1] & 0x0F ) | ( q << 4 );
+        }
+        else {
+            last->values[ch >> 1] = ( last->values[ch >> 1] & 0xF0 ) | q;
+        }
+    }
+
+    if ( nibbles & 1 ) {
+        pos++;
+    }
+
+    if ( ++last->count >= IMPREPORT_REFRESH ) {
+        last->count = 0;
+    }
+
+    return pos;
+}
+
+// Length of a received report (including the byte for the number of repetitions), 0 if it is malformed
+uint8_t impreport_length( const char *frame ) {
+    uint8_t channels = frame[2] & ~IMPREPORT_FULL, bytes = IMPREPORT_BYTES( channels ), nibbles = 0;
+
+    if ( !channels || ( channels > IMPREPORT_MAX_CHANNELS ) ) {
+        return 0;
+    }
+
+    // Count marked channels in change bitmap
+    for ( uint8_t i = 0; i < bytes; i++ ) {
+        for ( uint8_t bits = frame[3 + bytes + i]; bits; bits &= bits - 1 ) {
+            nibbles++;
+        }
+    }
+
+    return 3 + 2 * bytes + ( nibbles + 1 ) / 2 + 1;
+}
+
+// Number of channels below IMPREPORT_LIMIT
+uint8_t impreport_count( const char *frame ) {
+    uint8_t channels = frame[2] & ~IMPREPORT_FULL, count = 0;
+
+    for ( uint8_t ch = 0; ch < channels; ch++ ) {
+        if ( frame[3 + ( ch >> 3 )] & ( 1 << ( ch & 7 ) ) ) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// Quantized value of a channel within a table entry
+uint8_t impreport_value( const impentry_t *entry, const uint8_t ch ) {
+    return ( ch & 1 ) ? ( entry->values[ch >> 1] >> 4 ) : ( entry->values[ch >> 1] & 0x0F );
+}
+
+// Mark all boxes as not replied (before a new sweep), their values are kept for the next changes
+void impreport_restart( imptable_t *table ) {
+    for ( uint8_t i = 0; i < table->count; i++ ) {
+        table->box[i].channels = 0;
+    }
+
+    table->dropped = 0;
+}
+
+// Entry of a box, inserted at its place if it isn't in the table yet. Returns NULL if the table is full.
+static impentry_t *impreport_entry( imptable_t *table, const uint8_t uid ) {
+    uint8_t pos = 0;
+
+    while ( ( pos < table->count ) && ( table->box[pos].unique_id < uid ) ) {
+        pos++;
+    }
+
+    if ( ( pos < table->count ) && ( table->box[pos].unique_id == uid ) ) {
+        return &table->box[pos];
+    }
+
+    if ( table->count >= IMPTABLE_MAX ) {
+        table->dropped++;
+        return NULL;
+    }
+
+    // Replies of a sweep arrive in order of the Unique-ID, so there is mostly nothing to move
+    for ( uint8_t i = table->count++; i > pos; i-- ) {
+        table->box[i] = table->box[i - 1];
+    }
+
+    table->box[pos].unique_id = uid;
+
+    for ( uint8_t i = 0; i < sizeof( table->box[pos].values ); i++ ) {
+        table->box[pos].values[i] = ( IMPREPORT_OPEN << 4 ) | IMPREPORT_OPEN;
+    }
+
+    return &table->box[pos];
+}
+
+// Enter continuity and values of a received report into the table. Returns NULL if the report was not entered.
+impentry_t *impreport_store( imptable_t *table, const char *frame ) {
+    uint8_t     uid = frame[1], channels = frame[2] & ~IMPREPORT_FULL, bytes = IMPREPORT_BYTES( channels );
+    uint8_t     pos = 3 + 2 * bytes, nibbles = 0;
+    impentry_t *entry;
+
+    if ( !uid || ( uid > MAX_ID ) ) {
+        return NULL;
+    }
+
+    entry = impreport_entry( table, uid );
+
+    if ( !entry ) {
+        return NULL;
+    }
+
+    // A full report starts over, so values missed in between don't stick
+    if ( frame[2] & IMPREPORT_FULL ) {
+        for ( uint8_t i = 0; i < sizeof( entry->values ); i++ ) {
+            entry->values[i] = ( IMPREPORT_OPEN << 4 ) | IMPREPORT_OPEN;
+        }
+    }
+
+    // Apply the values of the marked channels
+    for ( uint8_t ch = 0; ch < channels; ch++ ) {
+        uint8_t q;
+
+        if ( !( frame[3 + bytes + ( ch >> 3 )] & ( 1 << ( ch & 7 ) ) ) ) {
+            continue;
+        }
+
+        q = ( nibbles & 1 ) ? ( (uint8_t) frame[pos++] >> 4 ) : ( frame[pos] & 0x0F );
+        nibbles++;
+
+        if ( ch & 1 ) {
+            entry->values[ch >> 1] = ( entry->values[ch >> 1] & 0x0F ) | ( q << 4 );
+        }
+        else {
+            entry->values[ch >> 1] = ( entry->values[ch >> 1] & 0xF0 ) | q;
+        }
+    }
+
+    for ( uint8_t i = 0; i < IMPREPORT_BYTES( IMPREPORT_MAX_CHANNELS ); i++ ) {
+        entry->status[i] = ( i < IMPREPORT_BYTES( channels ) ) ? frame[3 + i] : 0;
+    }
+
+    entry->channels = channels;
+
+    return entry;
+}
@@ -0,0 +1,47 @@
+/*
+ * memstat.h
+ * RAM-Belegung: statische Daten, Höchststand des Stacks (Füllmuster ab Start) und freier Speicher, dazu der
+ * aktive Anteil der Laufzeit
+ */
+
+#ifndef MEMSTAT_H_
+#define MEMSTAT_H_
+
+/*
+ * memstat_paint() runs from .init3 (stack pointer and zero register are set up by then) and fills the RAM between
+ * the end of the static data and the stack with MEMSTAT_PAINT. Bytes the stack ever reached don't carry the pattern
+ * anymore, so the untouched gap above the static data is the minimum of free RAM since the start.
+ *
+ * MEMREPORT message:
+ *
+ * [0]     MEMREPORT
+ * [1]     Unique-ID
+ * [2 3]   Static data (.data + .bss) in bytes, LSB first
+ * [4 5]   Highest stack usage in bytes
+ * [6 7]   Minimum of free RAM in bytes
+ * [8 9]   Free RAM when the report was made
+ * [10 11] Active share since start in 0.1 % (see idle.h)
+ * [12 13] Active share within the last window in 0.1 %
+ * [14]    Number of repetitions (as for every message)
+ */
+
+// Pattern for free RAM, a stack byte with the same value at the deepest point can make the high-water mark 1 byte low
+#define MEMSTAT_PAINT 0xC5
+
+// Ticks (10ms) between MEMREQUEST and the reply, only the requested box answers
+#define MEMSTAT_DELAY 10
+
+typedef struct {
+    uint16_t data;     // Static data (.data + .bss)
+    uint16_t stack;    // Highest stack usage since start
+    uint16_t free;     // Minimum of free RAM since start (never reached by the stack)
+    uint16_t free_now; // Free RAM between static data and the current stack pointer
+    uint16_t active;   // Active share since start in 0.1 %
+    uint16_t recent;   // Active share within the last window in 0.1 %
+} memstat_t;
+
+void    memstat_paint( void ) __attribute__( ( naked ) ) __attribute__( ( section( ".init3" ) ) );
+void    memstat_read( memstat_t *stat );
+void    memstat_to_frame( char *frame, const uint8_t uid );
+void    memstat_from_frame( const char *frame, memstat_t *stat );
+#endif
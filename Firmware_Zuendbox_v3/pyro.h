@@ -21,18 +21,55 @@
     #define MAX_ID                30
 #endif
 
+// Highest channel number that can be addressed within the network,
+// boxes ignore channels beyond their own SR_CHANNELS
+#define MAX_CHANNEL           64
+
+// Number of channels carried by an IMPEDANCES frame (limited by the 64 byte payload with AES)
+#if SR_CHANNELS > 60
+    #define IMPEDANCES_CHANNELS 60
+#else
+    #define IMPEDANCES_CHANNELS SR_CHANNELS
+#endif
+
 // Maximum Array Size for communication (UART + radio)
-#define MAX_COM_ARRAYSIZE     30
+#if ( IMPEDANCES_CHANNELS + 4 ) > 30
+    #define MAX_COM_ARRAYSIZE ( IMPEDANCES_CHANNELS + 4 )
+#else
+    #define MAX_COM_ARRAYSIZE 30
+#endif
 
 // Ignition time * 10ms
 #define IGNITION_TIME         2
 
+// Ticks (10ms) from the start of one impedance scan to the next one, values below the
+// duration of a scan (SR_CHANNELS ticks) let the scans run back to back
+#define IMP_SCAN_INTERVAL     125
+
+// Minimum settle time of a channel before measuring its impedance (Timer 1 counts, 2ms)
+#define IMP_SETTLE_COUNTS     ( F_CPU / 8 / 500 )
+
+// No impedance scan in progress
+#define IMP_IDLE              0xFF
+
+// ADC input for impedance measurements
+#define IMP_ADC_CHANNEL       4
+
+// Ticks (10ms) until a temperature conversion (9 bit, max. 93.75ms) is complete
+#define TEMP_CONV_TICKS       10
+
+// Configuration register of the DS18B20 for 9 bit resolution
+#define TEMP_CONFIG_9BIT      0x1F
+
+// Max. number of temperature sensors on the bus (in order of the ROM search, e.g. box and battery),
+// each one takes a byte in PARAMETERS
+#ifndef TEMP_SENSORS
+    #define TEMP_SENSORS      2
+#endif
+
 // Threshold to clear LCD (Number of counter overflows)
 #define DEL_THRES             251
 
-// Value for input timeout
-#define TIMEOUTVAL            ( F_CPU >> 4 )
-
 // Radio message types
 #define   FIRE                'f'
 #define   IDENT               'i'
@@ -42,23 +79,59 @@
 #define   CHANGE              'c'
 #define   MEASURE             'm'
 #define   IMPEDANCES          'z'
+#define   IMPREPORT           'q'
+#define   LOGREQUEST          'l'
+#define   LOGDATA             'g'
+#define   MEMREQUEST          'x'
+#define   MEMREPORT           'y'
+#define   STATUS              's'
+#define   STANDBY             'b'
+#define   WAKEUP              'w'
 #define   IDLE                0
 
+// IDENT: byte 1 selects a full identification (every device replies, lists are rebuilt) or a refresh (only boxes
+// that didn't reply within the epoch in byte 2 yet or whose parameters changed since their last reply)
+#define   IDENT_FULL          'd'
+#define   IDENT_DELTA         'g'
+#define   IDENT_REFRESH       'r'   // Refresh in the send menu (not a message type)
+
+// Changes that make a box reply to a refresh: battery voltage (0.1V), temperature (°C)
+#define   IDENT_BATTERY_BAND  3
+#define   IDENT_TEMP_BAND     2
+
+// Status push (STATUS, same layout as PARAMETERS): boxes sample battery and temperature every STATUS_SAMPLE_TICKS
+// and push a change after a random backoff, at most once per STATUS_HOLDOFF and not within STATUS_FIRE_HOLDOFF
+// after a FIRE message (10ms ticks)
+#define   STATUS_SAMPLE_TICKS   1000
+#define   STATUS_BACKOFF_MIN    20
+#define   STATUS_BACKOFF_SPREAD 200
+#define   STATUS_HOLDOFF        500
+#define   STATUS_FIRE_HOLDOFF   3000
+
 // Ceiled duration of byte transmission in microseconds
 #define   BYTE_DURATION_US    ( 8 * ( 1000000UL + BITRATE ) / BITRATE )
 
 #define   setTxCase( XX ) case XX: { loopcount = XX ## _REPEATS; tmp = XX ## _LENGTH - 1; break; }
 #define   waitRx( XX )    for ( uint8_t i = rx_field[XX ## _LENGTH - 1] - 1; i; i-- ) _delay_us ( ( ADDITIONAL_LENGTH + XX ## _LENGTH ) * BYTE_DURATION_US )
+#define   waitRxLength( LEN ) for ( uint8_t i = rx_field[( LEN ) - 1] - 1; i; i-- ) for ( uint8_t j = ADDITIONAL_LENGTH + ( LEN ); j; j-- ) _delay_us ( BYTE_DURATION_US )
 
 // Radio message lengths
 #define   ADDITIONAL_LENGTH   13 // Preamble (4) + Passwort (2) + Length Byte (1) + CRC (2) + Spare
 #define   FIRE_LENGTH         4
 #define   IDENT_LENGTH        4
 #define   MEASURE_LENGTH      4
-#define   PARAMETERS_LENGTH   7
+#define   PARAMETERS_LENGTH   ( 6 + TEMP_SENSORS )
 #define   TEMPERATURE_LENGTH  5
 #define   CHANGE_LENGTH       6
-#define   IMPEDANCES_LENGTH   19
+#define   IMPEDANCES_LENGTH   ( IMPEDANCES_CHANNELS + 3 )
+                                    // IMPREPORT: variable, see impreport_length()
+#define   LOGREQUEST_LENGTH   4
+#define   LOGDATA_LENGTH      ( BLACKBOX_MESSAGE + BLACKBOX_PER_MESSAGE * BLACKBOX_ENTRY_SIZE + 1 )
+#define   MEMREQUEST_LENGTH   4
+#define   MEMREPORT_LENGTH    15
+#define   STATUS_LENGTH       PARAMETERS_LENGTH
+#define   STANDBY_LENGTH      2
+#define   WAKEUP_LENGTH       2
 
 // Number of repetitions for radio messages
 #define   FIRE_REPEATS        5
@@ -68,65 +141,82 @@
 #define   TEMPERATURE_REPEATS 2
 #define   MEASURE_REPEATS     2
 #define   IMPEDANCES_REPEATS  2
-
-// Bitflags
+#define   IMPREPORT_REPEATS   2
+#define   LOGREQUEST_REPEATS  2
+#define   LOGDATA_REPEATS     2
+#define   MEMREQUEST_REPEATS  2
+#define   MEMREPORT_REPEATS   2
+#define   STATUS_REPEATS      2
+#define   STANDBY_REPEATS     3
+
+// WAKEUP is repeated for two listen periods, so every box in standby (see rfm69.h) catches one of them
+#define   WAKEUP_REPEATS      ( 2 * RFM69_LISTEN_PERIOD_US / ( ( ADDITIONAL_LENGTH + WAKEUP_LENGTH ) * BYTE_DURATION_US ) + 1 )
+
+// Main loop events, the lower the number the higher the priority
+#define   EV_FIRE             0  // Switch on a channel
+#define   EV_PULSE            1  // Monitor ignition pulses and end them
+#define   EV_RECEIVE          2  // Radio message waiting
+#define   EV_CLEAR_LIST       3  // Empty list of boxes (before an IDENT leaves)
+#define   EV_TRANSMIT         4  // Radio message may be sent
+#define   EV_RESET            5  // Software-Reset
+#define   EV_KEY              6  // Key switch changed
+#define   EV_UART             7  // UART input waiting
+#define   EV_MEASURE          8  // Measure impedance of the next channel
+#define   EV_CONFIG           9  // ID configuration
+#define   EV_REMOTE           10 // Remote ID configuration
+#define   EV_SEND             11 // Manual transmission
+#define   EV_HW               12 // Show hardware
+#define   EV_LIST             13 // List the next network device
+#define   EV_LIST_IMP         14 // List the next channel impedance
+#define   EV_TEMP             15 // Read temperature conversion
+#define   EV_LOG              16 // List the next entry of the event log
+#define   EV_STATUS           17 // Check for status changes and push them
+#define   EVENT_COUNT         18
+
+// Bitflags (states, one-shot jobs are events)
 typedef union {
     struct {
-        unsigned uart_active    : 1;
-        unsigned uart_config    : 1;
-        unsigned fire           : 1;
-        unsigned finish_firing  : 1;
         unsigned is_fire_active : 1;
-        unsigned send           : 1;
         unsigned transmit       : 1;
-        unsigned receive        : 1;
-        unsigned list           : 1;
-        unsigned read_impedance : 1;
+        unsigned ident_delta    : 1;
+        unsigned status_pending : 1;
         unsigned list_impedance : 1;
-        unsigned reset_device   : 1;
-        unsigned clear_list     : 1;
-        unsigned hw             : 1;
-        unsigned remote         : 1;
-    }        b;
-    uint16_t complete;
+    }       b;
+    uint8_t complete;
 } bitfeld_t;
 
 typedef struct {
+    uint8_t unique_id;
     uint8_t slave_id;
     uint8_t battery_voltage;
     uint8_t sharpness;
-    int8_t  temperature;
+    int8_t  temperature[TEMP_SENSORS];
     uint8_t rssi;
 } fireslave_t;
 
+// Parameters sent with the last reply to IDENT or STATUS
+typedef struct {
+    uint8_t epoch;                     // Epoch (byte 2) of the IDENT
+    uint8_t valid;                     // Replied since start
+    uint8_t armed;
+    uint8_t battery;
+    int8_t  temperature[TEMP_SENSORS];
+} identstate_t;
+
 #define KEY_DDR                      DDR( KEYPORT )
 #define KEY_PIN                      PIN( KEYPORT )
 #define KEY_PORT                     PORT( KEYPORT )
-#define KEY_NUMERIC                  NUMPORT( KEYPORT )
 #define KEY                          KEYNUM
-#if ( KEY_NUMERIC == 2 )
-    #define KEYINT                   PCINT1_vect
-#elif ( KEY_NUMERIC == 1 )
-    #define KEYINT                   PCINT0_vect
-#else
-    #define KEYINT                   PCINT2_vect
-#endif
 
 #define MOSSWITCHDDR                 DDR( MOSSWITCH_PORT )
 #define MOSSWITCHPIN                 PIN( MOSSWITCH_PORT )
 #define MOSSWITCHPORT                PORT( MOSSWITCH_PORT )
 #define MOSSWITCH                    MOSSWITCH_NUM
 
-// ID storage settings for EEPROM
+// Former fixed EEPROM addresses of IDs, AES key and RF power (imported once into the settings, see settings.h)
 #define START_ADDRESS_ID_STORAGE     24
 #define STEP_ID_STORAGE              36
 #define CRC_ID_STORAGE               16
-#define ID_MESS                                                                                               \
-    !( eeread( START_ADDRESS_ID_STORAGE )                                                                     \
-       == eeread( START_ADDRESS_ID_STORAGE + STEP_ID_STORAGE ) )                                              \
-    && ( eeread( START_ADDRESS_ID_STORAGE ) == eeread( START_ADDRESS_ID_STORAGE + 2 * STEP_ID_STORAGE ) )     \
-    && ( eeread( START_ADDRESS_ID_STORAGE + 1 ) == eeread( START_ADDRESS_ID_STORAGE + 1 + STEP_ID_STORAGE ) ) \
-    && ( eeread( START_ADDRESS_ID_STORAGE + 1 ) == eeread( START_ADDRESS_ID_STORAGE + 1 + 2 * STEP_ID_STORAGE ) )
 
 // Temperatursensoren
 #define DS18B20                      'o'
@@ -143,6 +233,12 @@ void    sr_dm_init( void );
 uint8_t asciihex( char inp );
 void    key_init( void );
 void    key_deinit( void );
-uint8_t debounce( volatile uint8_t *port, uint8_t pin );
+void    key_sample( void );
+uint8_t key_armed( void );
 uint8_t fire_command_uart_valid( const char *field );
+uint8_t ident_changed( const identstate_t *last, uint8_t armed, uint8_t battery, const int8_t temperature[TEMP_SENSORS] );
+void    ident_remember( identstate_t *last, uint8_t armed, uint8_t battery, const int8_t temperature[TEMP_SENSORS] );
+uint8_t ident_reply( identstate_t *last, const char *field, uint8_t armed, uint8_t battery, const int8_t temperature[TEMP_SENSORS] );
+void    status_seed( uint8_t uid );
+uint16_t status_random( void );
 #endif /* PYRO_H_ */
@@ -34,6 +34,12 @@
 /* Use Hardware-SPI if available? */
 #define RFM69_USE_HARDWARE_SPI 1
 
+/* Listen Mode (standby): the module receives for RFM69_LISTEN_RX * 64us,
+ * then idles for RFM69_LISTEN_IDLE * 4.1ms (1 ... 255 each).
+ * Armed boxes ignore STANDBY, a FIRE burst could fall between the receive windows */
+#define RFM69_LISTEN_RX        64   // 4.1ms
+#define RFM69_LISTEN_IDLE      61   // 250ms
+
 // Don't change anything from here
 #define XTALFREQ               32000000UL
 
@@ -84,17 +90,22 @@
 #define DATARATE_MSB           ( DATARATE >> 8 )
 #define DATARATE_LSB           ( DATARATE & 0xFF )
 
+#define RFM69_LISTEN_PERIOD_US ( RFM69_LISTEN_RX * 64UL + RFM69_LISTEN_IDLE * 4100UL )
+
 #define P_OUT                  ( ( P_OUT_DBM + 18 ) * ( P_OUT_DBM > -19 ) * ( P_OUT_DBM < 14 ) + 31 * ( P_OUT_DBM > 18 ) )
 
 #ifndef MAX_COM_ARRAYSIZE
     #define MAX_COM_ARRAYSIZE      30
 #endif
 
-// Value for input timeout
-#ifndef RFM69_TIMEOUTVAL
-    #define RFM69_TIMEOUTVAL   ( F_CPU >> 1 )
+// Timeout for mode changes of the module
+#ifndef RFM69_TIMEOUT_US
+    #define RFM69_TIMEOUT_US   CLOCK_MS( 100 )
 #endif
 
+// Timeout for sending a package (150 byte times)
+#define RFM69_TX_TIMEOUT_US    ( 150UL * 8 * 1000000UL / BR )
+
 #ifdef SPDR
     #define HASHARDSPI69       1
 #else
@@ -119,4 +130,7 @@ uint8_t rfm_transmit( char *data, uint8_t length ); // Transmit data
 uint8_t rfm_receive( char *data, uint8_t *length ); // Get received data
 
 uint8_t rfm_get_rssi_dbm( void );                   // Return RSSI-Value. Real RSSI = -1dBm * returned value
+
+void rfm_standby( uint8_t on );                     // Receive in Listen Mode (applied by the next rfm_rxon())
+uint8_t rfm_standby_active( void );                 // Listen Mode selected?
 #endif
@@ -0,0 +1,150 @@
+/*
+ * settings.c
+ *
+ * Settings kept in RAM, saved as records with wear-levelling (see settings.h for the layout)
+ */
+
+#include "global.h"
+
+_Static_assert( sizeof( settings_t ) <= SETTINGS_MAX_LENGTH, "settings_t does not fit into a slot!" );
+
+static settings_t settings_ram;
+static uint8_t    settings_slot = SETTINGS_SLOTS - 1; // Slot of the current record, the next save uses the following one
+static uint16_t   settings_seq  = 0;                  // Sequence number of the current record
+
+// Defaults for fields without a saved value
+static void settings_defaults( void ) {
+    settings_ram.unique_id = 'E';
+    settings_ram.slave_id  = 'e';
+
+    for ( uint8_t i = 0; i < 16; i++ ) {
+        settings_ram.aeskey[i] = 0xFF;
+    }
+
+    settings_ram.rfm_pwr = SETTINGS_NO_RFM_PWR;
+}
+
+// Read slot, returns the length of the payload or 0 if there is no valid record
+static uint8_t settings_read( uint8_t *slot, uint8_t i ) {
+    uint8_t length;
+
+    for ( uint8_t j = 0; j < SETTINGS_SLOT_SIZE; j++ ) {
+        slot[j] = eeread( SETTINGS_START + i * SETTINGS_SLOT_SIZE + j );
+    }
+
+    length = slot[3];
+
+    if (  !length || ( length > SETTINGS_MAX_LENGTH )
+       || ( crcwert( (char *) slot, 0, SETTINGS_HEADER + length, CRC16_SEED, 16 )
+            != ( slot[SETTINGS_HEADER + length] | ( slot[SETTINGS_HEADER + length + 1] << 8 ) ) ) ) {
+        return 0;
+    }
+
+    return length;
+}
+
+// Import the former fixed addresses (IDs, AES key, RF power), returns 1 if the IDs are valid
+static uint8_t settings_import( void ) {
+    uint8_t valid = addresses_legacy( &settings_ram.unique_id, &settings_ram.slave_id );
+
+    for ( uint8_t i = 0; i < 16; i++ ) {
+        settings_ram.aeskey[i] = eeread( START_ADDRESS_AESKEY_STORAGE + i );
+    }
+
+    #if ( RFM == 69 )
+        uint8_t rfm_pwr = eeread( RFM_PWR_ADDRESS );
+
+        if ( ( eeread( RFM_PWR_ADDRESS + 1 ) == crc8( 0x11, rfm_pwr ) ) && ( rfm_pwr < 0x20 ) ) {
+            settings_ram.rfm_pwr = rfm_pwr;
+        }
+    #endif
+
+    if ( valid ) {
+        settings_save();
+    }
+
+    return valid;
+}
+
+// Settings in RAM, changes have to be written with settings_save()
+settings_t *settings_get( void ) {
+    return &settings_ram;
+}
+
+// Find the current record (one pass over all slots) and copy it to RAM. Without any record the former fixed
+// addresses are imported. Returns 0 if there are no valid settings (defaults are used then)
+uint8_t settings_load( void ) {
+    uint8_t  slot[SETTINGS_SLOT_SIZE], length = 0;
+    uint16_t seq;
+
+    settings_defaults();
+
+    for ( uint8_t i = 0; i < SETTINGS_SLOTS; i++ ) {
+        if ( !settings_read( slot, i ) ) {
+            continue;
+        }
+
+        seq = slot[0] | ( slot[1] << 8 );
+
+        // Sequence numbers wrap around, the newer one is less than half the range ahead
+        if ( !length || ( (int16_t)( seq - settings_seq ) > 0 ) ) {
+            settings_slot = i;
+            settings_seq  = seq;
+            length        = slot[3];
+        }
+    }
+
+    if ( !length ) {
+        return settings_import();
+    }
+
+    settings_read( slot, settings_slot );
+
+    if ( length > sizeof( settings_t ) ) {
+        length = sizeof( settings_t );
+    }
+
+    for ( uint8_t i = 0; i < length; i++ ) {
+        ( (uint8_t *) &settings_ram )[i] = slot[SETTINGS_HEADER + i];
+    }
+
+    return 1;
+}
+
+// Queue settings as new record for the next slot, the EEPROM gets written in the background
+void settings_save( void ) {
+    uint8_t  slot[SETTINGS_SLOT_SIZE], next = ( settings_slot + 1 ) % SETTINGS_SLOTS;
+    uint16_t crc;
+
+    slot[0] = ( settings_seq + 1 ) & 0xFF;
+    slot[1] = ( settings_seq + 1 ) >> 8;
+    slot[2] = SETTINGS_VERSION;
+    slot[3] = sizeof( settings_t );
+
+    for ( uint8_t i = 0; i < sizeof( settings_t ); i++ ) {
+        slot[SETTINGS_HEADER + i] = ( (uint8_t *) &settings_ram )[i];
+    }
+
+    crc = crcwert( (char *) slot, 0, SETTINGS_HEADER + sizeof( settings_t ), CRC16_SEED, 16 );
+
+    slot[SETTINGS_HEADER + sizeof( settings_t )]     = crc & 0xFF;
+    slot[SETTINGS_HEADER + sizeof( settings_t ) + 1] = crc >> 8;
+
+    // CRC is written last, an interrupted write is never taken for a valid record
+    for ( uint8_t i = 0; i < SETTINGS_HEADER + sizeof( settings_t ) + 2; i++ ) {
+        eewrite( slot[i], SETTINGS_START + next * SETTINGS_SLOT_SIZE + i );
+    }
+
+    // A failed write leaves the previous record the current one after the next boot
+    settings_slot = next;
+    settings_seq++;
+}
+
+// Wait for the last record to be written, returns 1 if it has been read back correctly
+uint8_t settings_commit( void ) {
+    uint8_t slot[SETTINGS_SLOT_SIZE];
+
+    eeflush();
+
+    return settings_read( slot, settings_slot ) == sizeof( settings_t );
+}
@@ -0,0 +1,47 @@
+/*
+ * settings.h
+ * Einstellungen (IDs, AES-Schlüssel, Sendeleistung) als versionierte Datensätze mit CRC16 im EEPROM
+ */
+
+#ifndef SETTINGS_H_
+#define SETTINGS_H_
+
+/*
+ * Record layout (one slot):
+ *
+ * [0 ... 1]              Sequence number (LSB first), the valid record with the highest one is the current one
+ * [2]                    SETTINGS_VERSION of the firmware that wrote the record
+ * [3]                    Length of the payload
+ * [4 ...]                Payload (settings_t)
+ * [4 + length ... + 1]   CRC16 of bytes 0 ... 3 + length (as crcwert(), LSB first)
+ *
+ * Every save goes to the slot after the current one, so writes are spread over all slots and an interrupted
+ * write leaves the previous record valid. New settings are appended to settings_t: records of older versions
+ * are shorter, the missing fields keep their defaults.
+ */
+
+// First EEPROM address of the store (the former fixed addresses below are only read to import them once)
+#define SETTINGS_START     256
+#define SETTINGS_SLOT_SIZE 32
+#define SETTINGS_SLOTS     16
+#define SETTINGS_HEADER    4
+#define SETTINGS_VERSION   1
+
+// Payload of a slot at most
+#define SETTINGS_MAX_LENGTH ( SETTINGS_SLOT_SIZE - SETTINGS_HEADER - 2 )
+
+// RF power not saved, keep the default of the radio
+#define SETTINGS_NO_RFM_PWR 0xFF
+
+typedef struct {
+    uint8_t unique_id;
+    uint8_t slave_id;
+    uint8_t aeskey[16];
+    uint8_t rfm_pwr;    // Power register value (< 0x20) or SETTINGS_NO_RFM_PWR
+} settings_t;
+
+settings_t *settings_get( void );
+uint8_t     settings_load( void );
+void        settings_save( void );
+uint8_t     settings_commit( void );
+#endif
@@ -0,0 +1,101 @@
+/*
+ * slaves.c
+ *
+ * Table of the boxes that reported (see slaves.h)
+ */
+
+#include "global.h"
+
+// Index slot of a Unique-ID or the free slot where it belongs
+static uint8_t slaves_slot( const slavetable_t *table, const uint8_t uid ) {
+    uint8_t slot = ( uid - 1 ) & ( SLAVES_HASH - 1 );
+
+    while ( table->index[slot] && ( table->box[table->index[slot] - 1].unique_id != uid ) ) {
+        slot = ( slot + 1 ) & ( SLAVES_HASH - 1 );
+    }
+
+    return slot;
+}
+
+// Remove all boxes
+void slaves_clear( slavetable_t *table ) {
+    for ( uint8_t i = 0; i < table->count; i++ ) {
+        table->quantity[table->box[i].slave_id - 1] = 0;
+    }
+
+    for ( uint8_t i = 0; i < SLAVES_HASH; i++ ) {
+        table->index[i] = 0;
+    }
+
+    table->count   = 0;
+    table->dropped = 0;
+}
+
+// Box with this Unique-ID, NULL if it didn't report
+fireslave_t *slaves_find( slavetable_t *table, const uint8_t uid ) {
+    uint8_t slot = slaves_slot( table, uid );
+
+    return table->index[slot] ? &table->box[table->index[slot] - 1] : NULL;
+}
+
+// Enter box (Unique-ID and Slave-ID have to be 1 ... MAX_ID and the Unique-ID must not be in the table yet),
+// the other fields are left to the caller. Returns NULL if the table is full.
+fireslave_t *slaves_add( slavetable_t *table, const uint8_t uid, const uint8_t sid ) {
+    fireslave_t *box;
+
+    if ( table->count >= SLAVES_MAX ) {
+        table->dropped++;
+        return NULL;
+    }
+
+    box            = &table->box[table->count++];
+    box->unique_id = uid;
+    box->slave_id  = sid;
+
+    table->index[slaves_slot( table, uid )] = table->count;
+    table->quantity[sid - 1]++;
+
+    return box;
+}
+
+// Box with this Unique-ID, entered if it isn't in the table yet (refresh after IDENT, the Slave-ID may have changed).
+// Returns NULL if the table is full.
+fireslave_t *slaves_put( slavetable_t *table, const uint8_t uid, const uint8_t sid ) {
+    fireslave_t *box = slaves_find( table, uid );
+
+    if ( !box ) {
+        return slaves_add( table, uid, sid );
+    }
+
+    table->quantity[box->slave_id - 1]--;
+    table->quantity[sid - 1]++;
+    box->slave_id = sid;
+
+    return box;
+}
+
+// Sort boxes by Unique-ID (insertion sort, they mostly arrive in order anyway) and rebuild the index
+void slaves_sort( slavetable_t *table ) {
+    fireslave_t box;
+
+    for ( uint8_t i = 1; i < table->count; i++ ) {
+        uint8_t j = i;
+
+        box = table->box[i];
+
+        while ( j && ( table->box[j - 1].unique_id > box.unique_id ) ) {
+            table->box[j] = table->box[j - 1];
+            j--;
+        }
+
+        table->box[j] = box;
+    }
+
+    for ( uint8_t i = 0; i < SLAVES_HASH; i++ ) {
+        table->index[i] = 0;
+    }
+
+    for ( uint8_t i = 0; i < table->count; i++ ) {
+        table->index[slaves_slot( table, table->box[i].unique_id )] = i + 1;
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * slaves.h
+ * Tabelle der Boxen, die sich gemeldet haben (dichtes Feld mit offen adressiertem Index über die Unique-ID)
+ */
+
+#ifndef SLAVES_H_
+#define SLAVES_H_
+
+/*
+ * Only boxes that actually reported take space: they are kept in box[] in order of arrival, index[] maps a
+ * Unique-ID to its position (open addressing with linear probing, (Unique-ID - 1) modulo SLAVES_HASH as start).
+ * The number of boxes per Slave-ID is counted on every insertion, clearing only touches the entries present.
+ */
+
+// Maximum number of boxes in the table: all Unique-IDs up to 64, larger builds keep the first 64 boxes that report
+// (-DSLAVES_MAX=... to change, further boxes are counted in dropped)
+#ifndef SLAVES_MAX
+    #if MAX_ID > 64
+        #define SLAVES_MAX    64
+    #else
+        #define SLAVES_MAX    MAX_ID
+    #endif
+#endif
+
+// Slots of the index: next power of 2 from SLAVES_MAX on, one slot more if foreign Unique-IDs can probe a full table
+// (with MAX_ID <= SLAVES_HASH there are no collisions at all)
+#define SLAVES_SLOTS  ( SLAVES_MAX + ( MAX_ID > SLAVES_MAX ) )
+
+#ifndef SLAVES_HASH
+    #if SLAVES_SLOTS > 64
+        #define SLAVES_HASH   128
+    #elif SLAVES_SLOTS > 32
+        #define SLAVES_HASH   64
+    #elif SLAVES_SLOTS > 16
+        #define SLAVES_HASH   32
+    #else
+        #define SLAVES_HASH   16
+    #endif
+#endif
+
+#if ( SLAVES_HASH & ( SLAVES_HASH - 1 ) ) || ( SLAVES_HASH < SLAVES_SLOTS )
+    #error "SLAVES_HASH has to be a power of 2 and more than SLAVES_MAX (or equal if MAX_ID <= SLAVES_MAX)!"
+#endif
+
+#if SLAVES_HASH > 128
+    #error "SLAVES_MAX is too big!"
+#endif
+
+typedef struct {
+    fireslave_t box[SLAVES_MAX];      // Boxes in order of arrival (sorted by Unique-ID with slaves_sort())
+    uint8_t     index[SLAVES_HASH];   // Position in box[] + 1, 0 = free
+    uint8_t     quantity[MAX_ID];     // Number of boxes per Slave-ID (index = Slave-ID - 1)
+    uint8_t     count;                // Boxes in box[]
+    uint8_t     dropped;              // Boxes not entered because the table was full
+} slavetable_t;
+
+void         slaves_clear( slavetable_t *table );
+fireslave_t *slaves_find( slavetable_t *table, const uint8_t uid );
+fireslave_t *slaves_add( slavetable_t *table, const uint8_t uid, const uint8_t sid );
+fireslave_t *slaves_put( slavetable_t *table, const uint8_t uid, const uint8_t sid );
+void         slaves_sort( slavetable_t *table );
+#endif
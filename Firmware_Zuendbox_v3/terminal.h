@@ -24,7 +24,11 @@ uint8_t remote_config( char *txf );
 uint8_t configprog( const uint8_t devicetype );
 uint8_t aesconf( void );
 
-void list_complete( fireslave_t slaves[MAX_ID + 1], uint8_t wrongids );
-void list_array( char *arr );
-void evaluate_boxes( fireslave_t boxes[MAX_ID + 1], char *quantity );
+void list_complete( const slavetable_t *table, uint8_t wrongids, uint8_t i );
+void list_array( const uint8_t *quantity, uint8_t i, uint8_t n );
+void list_blackbox( uint8_t uid, const blackbox_entry_t *entry );
+void list_memstat( uint8_t uid, const memstat_t *stat );
+#if PROFILING
+    void list_prof( void );
+#endif
 #endif /* TERMINAL_H_ */
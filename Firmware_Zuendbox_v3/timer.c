@@ -7,6 +7,8 @@
 
 #include "global.h"
 
+static volatile uint32_t clock_count = 0; // 10ms ticks since start
+
 // Activate Timer 1 (Prescaler 8)
 void timer1_on( void ) {
     TCCR1B |= ( 1 << CS11 );
@@ -14,7 +16,7 @@ void timer1_on( void ) {
 
 // Initialise timer 1
 void timer1_init( void ) {
-    OCR1A   = 12287;
+    OCR1A   = TIMER1_TOP;
     TCCR1B |= ( 1 << WGM12 ); // CTC-Modus mit Prescaler 8 => f_C1 = 750 kHZ, T = 0,01 s = 10 ms
     TIMSK1 |= ( 1 << OCIE1A );
 }
@@ -24,8 +26,74 @@ void timer1_off( void ) {
     TCCR1B &= ~( 1 << CS12 | 1 << CS11 | 1 << CS10 );
 }
 
-// Reset Timer 1 (Counter to 0, clear compare flag)
-void timer1_reset( void ) {
-    TIFR1 = ( 1 << OCF1A );
-    TCNT1 = 0;
+// Count time (Timer 1, every 10ms)
+void clock_tick( void ) {
+    clock_count++;
+}
+
+// Interrupts disabled: count a pending compare match here (the ISR won't see it), returns 1 if there was one
+uint8_t clock_poll( void ) {
+    if ( !( SREG & ( 1 << SREG_I ) ) && ( TIFR1 & ( 1 << OCF1A ) ) ) {
+        TIFR1 = ( 1 << OCF1A );
+        clock_count++;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Ticks and counter of Timer 1 at the same instant
+static uint32_t clock_read( uint16_t *counts ) {
+    uint8_t  temp_sreg = SREG;
+    uint32_t ticks;
+
+    cli();
+    ticks   = clock_count;
+    *counts = TCNT1;
+
+    // Compare match not handled yet, counter has already started again
+    if ( TIFR1 & ( 1 << OCF1A ) ) {
+        ticks++;
+        *counts = TCNT1;
+    }
+
+    SREG = temp_sreg;
+
+    return ticks;
+}
+
+// 10ms ticks since start
+uint32_t clock_ticks( void ) {
+    uint16_t counts;
+
+    return clock_read( &counts );
+}
+
+// Microseconds since start (wraps after about 71 minutes)
+uint32_t clock_us( void ) {
+    uint16_t counts;
+    uint32_t ticks = clock_read( &counts );
+
+    return ticks * CLOCK_TICK_US + (uint32_t) counts * CLOCK_TICK_US / ( TIMER1_TOP + 1 );
+}
+
+// Milliseconds since start
+uint32_t clock_ms( void ) {
+    uint16_t counts;
+    uint32_t ticks = clock_read( &counts );
+
+    return ticks * ( CLOCK_TICK_US / 1000 ) + (uint32_t) counts * ( CLOCK_TICK_US / 1000 ) / ( TIMER1_TOP + 1 );
+}
+
+// Counts of Timer 1 since start (wraps after about 58 minutes), cheap timestamp for measuring durations
+uint32_t clock_counts( void ) {
+    uint16_t counts;
+    uint32_t ticks = clock_read( &counts );
+
+    return ticks * ( TIMER1_TOP + 1 ) + counts;
+}
+
+// Counts of Timer 1 in microseconds
+uint32_t clock_counts_us( uint32_t counts ) {
+    return counts / ( TIMER1_TOP + 1 ) * CLOCK_TICK_US + counts % ( TIMER1_TOP + 1 ) * CLOCK_TICK_US / ( TIMER1_TOP + 1 );
 }
\ No newline at end of file
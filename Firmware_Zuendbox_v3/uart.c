@@ -48,12 +48,12 @@ void uart_init( uint32_t baud ) {
 // Receive char
 uint8_t uart_getc( void ) {
     uint8_t  udrcontent;
-    uint32_t utimer = UART_TIMEOUTVAL;
+    uint32_t deadline = clock_deadline( UART_TIMEOUT_US );
 
-    while ( --utimer && !( UCSR0A & ( 1 << RXC0 ) ) ); // wait until char available or timeout
-
-    if ( !utimer ) {
-        return '\0';
+    while ( !( UCSR0A & ( 1 << RXC0 ) ) ) { // wait until char available or timeout
+        if ( clock_expired( deadline ) ) {
+            return '\0';
+        }
     }
 
     block_uart_sending();
@@ -107,16 +107,18 @@ uint8_t uart_gets( char *s ) {
 
 // Transmit char
 uint8_t uart_putc( uint8_t c ) {
-    uint32_t utimer;
-    utimer = UART_TIMEOUTVAL;
+    uint32_t deadline = clock_deadline( UART_TIMEOUT_US );
+    uint8_t  expired  = 0;
     #if RTSCTSFLOW
-        while ( --utimer && ( CTS_PIN & ( 1 << CTS ) ) );  /* wait till sending is allowed */
+        while ( !expired && ( CTS_PIN & ( 1 << CTS ) ) ) {  /* wait till sending is allowed */
+            expired = clock_expired( deadline );
+        }
     #endif
 
-    if ( utimer ) {
-        utimer = UART_TIMEOUTVAL;
+    if ( !expired ) {
+        deadline = clock_deadline( UART_TIMEOUT_US );
 
-        while ( --utimer && !( UCSR0A & ( 1 << UDRE0 ) ) );
+        while ( !( UCSR0A & ( 1 << UDRE0 ) ) && !clock_expired( deadline ) );
 
         switch ( c ) {
             /*case '�': {
@@ -298,4 +300,9 @@ uint8_t uart_lower_case( char letter ) {
     }
 
     return letter;
+}
+
+// Reception while sleeping (see idle_sleep()): only wakes up the CPU, the main loop reads the data itself
+ISR( USART_RX_vect ) {
+    UCSR0B &= ~( 1 << RXCIE0 );
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * crccheck.c
+ *
+ * Host test: the table driven crc8() and crc16() (CRC_TABLES 1 and 2) have to give the same result as the
+ * bit by bit code (CRC_TABLES 0) for every register value and every data byte. Afterwards crcwert() of every
+ * variant is timed over a message buffer (host times only show the ratio between the variants, not AVR cycles).
+ *
+ * Build and run (from this directory, for the v3 box with -I../../Firmware_Zuendbox_v3):
+ *   gcc -O2 -Wall -I../../Firmware_Sources -o crccheck crccheck.c && ./crccheck
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+// crcchk.c is compiled without the AVR headers
+#define GLOBAL_H_
+#define PROGMEM
+#define pgm_read_word( P ) ( *( P ) )
+#define pgm_read_byte( P ) ( *( P ) )
+
+// Every variant of crcchk.c gets its own names
+#define CRC_TABLES  0
+#define crc16       crc16_bits
+#define crc8        crc8_bits
+#define crcwert     crcwert_bits
+#include "crcchk.c"
+#undef CRC_TABLES
+#undef crc16
+#undef crc8
+#undef crcwert
+
+#define CRC_TABLES  1
+#define crc16       crc16_nibbles
+#define crc8        crc8_nibbles
+#define crcwert     crcwert_nibbles
+#define crc16_table crc16_table_nibbles
+#define crc8_table  crc8_table_nibbles
+#include "crcchk.c"
+#undef CRC_TABLES
+#undef crc16
+#undef crc8
+#undef crcwert
+#undef crc16_table
+#undef crc8_table
+
+#define CRC_TABLES  2
+#define crc16       crc16_bytes
+#define crc8        crc8_bytes
+#define crcwert     crcwert_bytes
+#define crc16_table crc16_table_bytes
+#define crc8_table  crc8_table_bytes
+#include "crcchk.c"
+
+// Rounds over the buffer for the timing
+#define ROUNDS 200000UL
+
+typedef uint16_t ( *crcwert_t )( char *feld, uint8_t startindex, uint8_t laenge, uint16_t crc, uint8_t crctype );
+
+// Nanoseconds per byte of crcwert() over a buffer of the maximum message length
+static double crccheck_time( crcwert_t crcwert, uint8_t crctype ) {
+    static char       buffer[255];
+    volatile uint16_t sink = 0;
+    struct timespec   start, end;
+
+    for ( uint16_t i = 0; i < sizeof( buffer ); i++ ) {
+        buffer[i] = (char) ( i * 31 + 7 );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    for ( uint32_t round = 0; round < ROUNDS; round++ ) {
+        sink += crcwert( buffer, 0, sizeof( buffer ), (uint16_t) round, crctype );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &end );
+    (void) sink;
+
+    return ( ( end.tv_sec - start.tv_sec ) * 1e9 + ( end.tv_nsec - start.tv_nsec ) ) / ( (double) ROUNDS * sizeof( buffer ) );
+}
+
+int main( void ) {
+    static const struct {
+        const char *name;
+        crcwert_t   crcwert;
+    } variants[] = { { "bits    (CRC_TABLES 0)", crcwert_bits },
+                     { "nibbles (CRC_TABLES 1)", crcwert_nibbles },
+                     { "bytes   (CRC_TABLES 2)", crcwert_bytes } };
+    uint32_t errors = 0;
+
+    for ( uint32_t seed = 0; seed < 0x10000UL; seed++ ) {
+        for ( uint16_t data = 0; data < 0x100; data++ ) {
+            uint16_t ref = crc16_bits( seed, data );
+
+            if ( ( crc16_nibbles( seed, data ) != ref ) || ( crc16_bytes( seed, data ) != ref ) ) {
+                if ( errors++ < 10 ) {
+                    printf( "CRC16 seed 0x%04X data 0x%02X: bits 0x%04X, nibbles 0x%04X, bytes 0x%04X\n", (unsigned) seed,
+                            data, ref, crc16_nibbles( seed, data ), crc16_bytes( seed, data ) );
+                }
+            }
+
+            if ( seed < 0x100 ) {
+                uint8_t ref8 = crc8_bits( seed, data );
+
+                if ( ( crc8_nibbles( seed, data ) != ref8 ) || ( crc8_bytes( seed, data ) != ref8 ) ) {
+                    if ( errors++ < 10 ) {
+                        printf( "CRC8 seed 0x%02X data 0x%02X: bits 0x%02X, nibbles 0x%02X, bytes 0x%02X\n", (unsigned) seed,
+                                data, ref8, crc8_nibbles( seed, data ), crc8_bytes( seed, data ) );
+                    }
+                }
+            }
+        }
+    }
+
+    printf( "CRC8: 256 x 256, CRC16: 65536 x 256 checked, %u errors\n", (unsigned) errors );
+
+    if ( errors ) {
+        return 1;
+    }
+
+    printf( "\ncrcwert() over %u bytes, ns per byte:  CRC8    CRC16\n", 255U );
+
+    for ( uint8_t i = 0; i < sizeof( variants ) / sizeof( variants[0] ); i++ ) {
+        printf( "  %s             %6.2f  %6.2f\n", variants[i].name, crccheck_time( variants[i].crcwert, 8 ),
+                crccheck_time( variants[i].crcwert, 16 ) );
+    }
+
+    return 0;
+}